@@ -0,0 +1,10 @@
+SPIN:	LW R1 4(R10)
+	BEQZ R1 SPIN
+	LW R2 0(R10)
+	ADDI R5 R0 50
+L2:	ADDI R6 R5 0
+	SW R6 0(R10)
+	SUBI R5 R5 1
+	BNEZ R5 L2
+	SW R2 8(R10)
+	EOP
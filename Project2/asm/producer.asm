@@ -0,0 +1,10 @@
+	ADDI R1 R0 200
+	ADDI R3 R0 0
+LOOP:	ADD R3 R3 R1
+	ADDI R6 R3 0
+	SW R6 0(R10)
+	SUBI R1 R1 1
+	BNEZ R1 LOOP
+	ADDI R4 R0 1
+	SW R4 4(R10)
+	EOP
@@ -0,0 +1,9 @@
+	ADDI R5 R0 20
+	ADDI R10 R0 0xA000
+LOOP:	SW R5 0(R10)
+	LW R6 0(R10)
+	ADD R7 R7 R6
+	SUBI R5 R5 1
+	ADDI R10 R10 4
+	BNEZ R5 LOOP
+	EOP
@@ -0,0 +1,6 @@
+	ADDI R1 R0 1000
+	ADDI R2 R0 0
+LOOP:	ADD R2 R2 R1
+	SUBI R1 R1 1
+	BNEZ R1 LOOP
+	EOP
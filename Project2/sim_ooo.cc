@@ -6,6 +6,16 @@
 #include <string>
 #include <iomanip>
 #include <map>
+#include <vector>
+#include <math.h>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 using namespace std;
 
@@ -14,6 +24,14 @@ static const char *stage_names[NUM_STAGES] = {"ISSUE", "EXE", "WR", "COMMIT"};
 static const char *instr_names[NUM_OPCODES] = {"LW", "SW", "ADD", "ADDI", "SUB", "SUBI", "XOR", "XORI", "OR", "ORI", "AND", "ANDI", "MULT", "DIV", "BEQZ", "BNEZ", "BLTZ", "BGTZ", "BLEZ", "BGEZ", "JUMP", "EOP", "LWS", "SWS", "ADDS", "SUBS", "MULTS", "DIVS"};
 static const char *res_station_names[5]={"Int", "Add", "Mult", "Load"};
 
+#define NO_STAGE ((stage_t)0) //state of an empty rob entry
+#define FP_REGISTER 0x20 //set in a packed register id for floating point registers
+#define FRONT_RING_SIZE 4096 //records buffered between the functional front and the timing model (power of two)
+#define TRACE_BLOCK 4096 //records per block of a trace file
+#define LOOP_MAX_BODY 1024 //longest loop iteration, in instructions, considered for extrapolation
+#define MAX_PREDICTOR_BITS 20 //largest index_bits accepted by set_branch_predictor
+#define TAGE_TAG_BITS 8 //bits of the partial tag of a TAGE entry
+
 struct reservation_station
 {
 	string name;
@@ -24,6 +42,8 @@ struct reservation_station
 	unsigned qj, qk, dest;
 	unsigned a;
 	unsigned pc;
+	unsigned next_j, next_k; //next waiter on the rob entry this operand is waiting for
+	unsigned unit; //exe_unit_t the instruction executes on
 	bool wb = false;
 	bool cleared = false;
 };
@@ -35,7 +55,10 @@ struct ex_unit
 	unsigned opcode;
 	int vj, vk;
 	float vjf, vkf;
-	int ttf, delay; //ttf time-to-finish
+	int delay;
+	unsigned type; //exe_unit_t
+	unsigned finish; //clock cycle in which the result is written
+	ex_unit *next; //next unit in the same timing wheel slot (or release list)
 	unsigned entry;
 	unsigned pc;
 };
@@ -44,13 +67,24 @@ struct read_order_buffer
 {
 	unsigned entry;
 	bool busy, ready;
-	unsigned instruction;
-	string state;
-	string destination;
+	unsigned opcode;
+	stage_t state; //NO_STAGE if the entry is empty
+	unsigned destination; //packed register id, UNDEFINED if the instruction writes no register
 	int value;
 	float value_f;
 	unsigned pc;
+	unsigned long long seq; //age of the instruction, lower is older
+	unsigned long long log_index; //position of this instruction in the execution log, UNDEFINED_LOG if not logged
+	unsigned waiters; //first station operand waiting for this entry's result, UNDEFINED if none
 	bool commit_stall;
+	bool traced; //the result comes from the functional front (rob_trace) instead of being computed
+	bool predicted_taken; //issue continued at the target of this branch or jump
+	bool btb_miss; //the branch was predicted taken but its target was not in the BTB
+	unsigned long long history; //global history the branch was predicted with
+	bool mispredicted; //resolved against its prediction in write result, which already redirected issue
+	bool checkpointed; //the branch holds a rename checkpoint, saved in its slot of rename_map
+	unsigned data_entry; //store: entry that produced the stored register when it issued, UNDEFINED if none was pending
+	bool delayed; //load: held back at least once by an older store
 };
 
 struct int_register
@@ -68,27 +102,93 @@ struct fp_register
 struct instruction_q
 {
 	unsigned pc;
-	unsigned Issue, Exe, WR, Commit;
+	unsigned long long Issue, Exe, WR, Commit; //cycle of each stage, UNDEFINED_CYCLE if not reached
+};
+
+//instruction fields extracted once by load_program so that the pipeline never decodes
+struct decoded_instruction
+{
+	unsigned opcode;
+	unsigned station; //res_station_t used at issue, 0 for an empty word
+	unsigned unit; //exe_unit_t that executes the instruction
+	bool int_or_float; //true if dest/src registers are integer registers (the base of a load/store always is)
+	unsigned dest, src1, src2; //register indexes, UNDEFINED if not used
+	unsigned imm; //immediate or load/store offset, UNDEFINED if not used
+	unsigned target; //resolved branch/jump target, UNDEFINED if not a branch
+};
+
+//outcome of one executed instruction, produced by the functional model
+struct dynamic_instruction
+{
+	unsigned pc; //byte address of the instruction
+	unsigned next_pc; //word index of the next instruction on the correct path
+	int value; //result as the timing model writes it to the rob: integer or float bits, store address or branch target
+	float value_f; //result of a floating point instruction or LWS
+	unsigned address; //effective address of a load or store, UNDEFINED otherwise
+	bool taken; //branch outcome
+};
+
+//functional model running ahead of the timing model on its own thread; records flow through a
+//single-producer/single-consumer ring, so neither side takes a lock
+struct functional_front
+{
+	std::thread producer;
+	std::atomic<bool> stop; //set by the timing model to end the producer early
+	std::atomic<bool> done; //set by the producer after its last record
+	std::atomic<unsigned long long> head; //next record read by the timing model
+	std::atomic<unsigned long long> tail; //next record written by the producer
+	dynamic_instruction ring[FRONT_RING_SIZE];
+
+	//producer side: a private copy of the architectural state
+	int r[NUM_GP_REGISTERS];
+	float f[NUM_GP_REGISTERS];
+	unsigned char *memory;
+	unsigned memory_size;
+	unsigned pc;
+	const decoded_instruction *program;
+	unsigned program_end;
+
+	//consumer side
+	bool wrong_path; //issue is past a taken branch, whose instructions have no record
+	struct trace_reader *trace; //when replaying a trace, records are read from it by the consumer and there is no producer
+	unsigned long long trace_left; //records not yet read from the trace
 };
 
-reservation_station* int_rs;
-reservation_station* add_rs;
-reservation_station* mult_rs;
-reservation_station* load_rs;
+//one entry of a tagged TAGE table
+struct tage_entry
+{
+	unsigned short tag; //0xFFFF if the entry was never allocated
+	signed char counter; //3-bit signed counter, taken if >= 0
+	unsigned char useful; //2-bit usefulness, entries at 0 can be replaced
+};
 
-ex_unit* int_ex;
-ex_unit* add_ex;
-ex_unit* mult_ex;
-ex_unit* div_ex;
-ex_unit* mem_ex;
+//direction tables, BTB and global history of the branch predictor
+struct branch_predictor
+{
+	predictor_t kind;
+	unsigned index_bits;
+	unsigned char *counters; //2-bit counters, taken if >= 2: the bimodal or gshare table, or the TAGE base table
+	tage_entry *tagged; //TAGE_TABLES tables of 2^index_bits entries, NULL unless kind is PREDICT_TAGE
+	unsigned btb_size; //power of two
+	unsigned *btb_pc, *btb_target; //direct-mapped; btb_pc is UNDEFINED for an empty entry
+	unsigned long long history; //outcomes of the conditional branches issued, newest in bit 0 (unused by bimodal)
+	unsigned long long retired_history; //the same for the committed ones, which issue goes back to after a flush
+	unsigned long long updates; //number of times a table entry changed
+};
 
-read_order_buffer* rob;
+static const char *predictor_names[4] = {"not-taken", "bimodal", "gshare", "TAGE"};
+static const unsigned tage_history_lengths[TAGE_TABLES] = {4, 8, 16, 32};
 
-int_register* int_reg;
-fp_register* fp_reg;
+/* packs a register index and its register file into a single id */
+inline unsigned pack_register(unsigned reg, bool int_or_float){
+	if (reg >= NUM_GP_REGISTERS) return UNDEFINED;
+	return int_or_float ? reg : (reg | FP_REGISTER);
+}
 
-instruction_q* iq;
-instruction_q* il;
+/* returns the register index of a packed register id */
+inline unsigned register_index(unsigned id){
+	return id & (FP_REGISTER - 1);
+}
 
 /* convert a float into an unsigned */
 inline unsigned float2unsigned(float value){
@@ -104,6 +204,20 @@ inline float unsigned2float(unsigned value){
         return result;
 }
 
+/* convert a double into its 64-bit pattern */
+inline unsigned long long float2unsigned_double(double value){
+        unsigned long long result;
+        memcpy(&result, &value, sizeof value);
+        return result;
+}
+
+/* convert a 64-bit pattern into a double */
+inline double unsigned2float_double(unsigned long long value){
+        double result;
+        memcpy(&result, &value, sizeof value);
+        return result;
+}
+
 /* convert integer into array of unsigned char - little indian */
 inline void unsigned2char(unsigned value, unsigned char *buffer){
         buffer[0] = value & 0xFF;
@@ -114,7 +228,282 @@ inline void unsigned2char(unsigned value, unsigned char *buffer){
 
 /* convert array of char into integer - little indian */
 inline unsigned char2unsigned(unsigned char *buffer){
-       return buffer[0] + (buffer[1] << 8) + (buffer[2] << 16) + (buffer[3] << 24);
+       return buffer[0] + (buffer[1] << 8) + (buffer[2] << 16) + ((unsigned)buffer[3] << 24);
+}
+
+/* two-sided 95% quantiles of Student's t distribution for 1 to 30 degrees of freedom */
+static const double student_t_95[30] = {12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+	2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+	2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042};
+
+/* checkpoint fields are stored little-endian whatever the host */
+static const char checkpoint_magic[8] = {'S', 'I', 'M', 'O', 'O', 'O', 'C', 'P'};
+static const char trace_magic[8] = {'S', 'I', 'M', 'O', 'O', 'O', 'T', 'R'};
+
+inline void write_u32(ostream &out, unsigned value){
+        unsigned char buffer[4];
+        unsigned2char(value, buffer);
+        out.write((const char *)buffer, 4);
+}
+
+inline void write_u64(ostream &out, unsigned long long value){
+        write_u32(out, (unsigned)value);
+        write_u32(out, (unsigned)(value >> 32));
+}
+
+inline unsigned read_u32(istream &in){
+        unsigned char buffer[4] = {0, 0, 0, 0};
+        in.read((char *)buffer, 4);
+        return buffer[0] | (buffer[1] << 8) | (buffer[2] << 16) | ((unsigned)buffer[3] << 24);
+}
+
+inline unsigned long long read_u64(istream &in){
+        unsigned long long low = read_u32(in);
+        return low | ((unsigned long long)read_u32(in) << 32);
+}
+
+static branch_predictor *new_predictor(predictor_t kind, unsigned index_bits, unsigned btb_size)
+{
+	branch_predictor *p = new branch_predictor;
+	p->kind = kind;
+	p->index_bits = index_bits;
+	p->counters = new unsigned char[1u << index_bits];
+	memset(p->counters, 1, 1u << index_bits); // weakly not taken
+	p->tagged = NULL;
+	if (kind == PREDICT_TAGE)
+	{
+		p->tagged = new tage_entry[TAGE_TABLES << index_bits];
+		for (unsigned i = 0; i < ((unsigned)TAGE_TABLES << index_bits); i++)
+		{
+			p->tagged[i].tag = 0xFFFF;
+			p->tagged[i].counter = 0;
+			p->tagged[i].useful = 0;
+		}
+	}
+	p->btb_size = btb_size;
+	p->btb_pc = new unsigned[btb_size];
+	p->btb_target = new unsigned[btb_size];
+	for (unsigned i = 0; i < btb_size; i++)
+	{
+		p->btb_pc[i] = UNDEFINED;
+		p->btb_target[i] = UNDEFINED;
+	}
+	p->history = 0;
+	p->retired_history = 0;
+	p->updates = 0;
+	return p;
+}
+
+static void delete_predictor(branch_predictor *p)
+{
+	if (p == NULL)
+	{
+		return;
+	}
+	delete[] p->counters;
+	delete[] p->tagged;
+	delete[] p->btb_pc;
+	delete[] p->btb_target;
+	delete p;
+}
+
+/* xors the last "length" outcomes of "history" down to "bits" bits */
+static unsigned fold_history(unsigned long long history, unsigned length, unsigned bits)
+{
+	history &= length < 64 ? (1ULL << length) - 1 : ~0ULL;
+	unsigned folded = 0;
+	while (history != 0)
+	{
+		folded ^= (unsigned)(history & ((1ULL << bits) - 1));
+		history >>= bits;
+	}
+	return folded;
+}
+
+static unsigned tage_index(const branch_predictor &p, unsigned table, unsigned pc, unsigned long long history)
+{
+	unsigned mask = (1u << p.index_bits) - 1;
+	return (pc ^ (pc >> p.index_bits) ^ fold_history(history, tage_history_lengths[table], p.index_bits)) & mask;
+}
+
+static unsigned tage_tag(unsigned table, unsigned pc, unsigned long long history)
+{
+	unsigned length = tage_history_lengths[table];
+	return (pc ^ fold_history(history, length, TAGE_TAG_BITS) ^ (fold_history(history, length, TAGE_TAG_BITS - 1) << 1))
+		& ((1u << TAGE_TAG_BITS) - 1);
+}
+
+/* finds the longest matching TAGE table ("provider") and the next longest ("alternate"), -1 if none */
+static void tage_lookup(const branch_predictor &p, unsigned pc, unsigned long long history, unsigned *index,
+	int &provider, int &alternate)
+{
+	provider = alternate = -1;
+	for (int t = TAGE_TABLES - 1; t >= 0; t--)
+	{
+		index[t] = tage_index(p, t, pc, history);
+		if (p.tagged[(t << p.index_bits) + index[t]].tag == tage_tag(t, pc, history))
+		{
+			if (provider == -1)
+			{
+				provider = t;
+			}
+			else if (alternate == -1)
+			{
+				alternate = t;
+			}
+		}
+	}
+}
+
+static bool predict_direction(const branch_predictor &p, unsigned pc, unsigned long long history)
+{
+	unsigned mask = (1u << p.index_bits) - 1;
+	switch (p.kind)
+	{
+	case PREDICT_GSHARE:
+		return p.counters[(pc ^ (unsigned)history) & mask] >= 2;
+	case PREDICT_TAGE:
+	{
+		unsigned index[TAGE_TABLES];
+		int provider, alternate;
+		tage_lookup(p, pc, history, index, provider, alternate);
+		if (provider != -1)
+		{
+			return p.tagged[(provider << p.index_bits) + index[provider]].counter >= 0;
+		}
+		return p.counters[pc & mask] >= 2;
+	}
+	default:
+		return p.counters[pc & mask] >= 2;
+	}
+}
+
+/* moves a saturating counter towards "taken", counting the change in "updates" */
+static void train_counter(unsigned char &counter, bool taken, unsigned long long &updates)
+{
+	if (taken && counter < 3)
+	{
+		counter++;
+		updates++;
+	}
+	else if (!taken && counter > 0)
+	{
+		counter--;
+		updates++;
+	}
+}
+
+static void train_direction(branch_predictor &p, unsigned pc, unsigned long long history, bool taken)
+{
+	unsigned mask = (1u << p.index_bits) - 1;
+	if (p.kind == PREDICT_GSHARE)
+	{
+		train_counter(p.counters[(pc ^ (unsigned)history) & mask], taken, p.updates);
+		return;
+	}
+	if (p.kind != PREDICT_TAGE)
+	{
+		train_counter(p.counters[pc & mask], taken, p.updates);
+		return;
+	}
+
+	unsigned index[TAGE_TABLES];
+	int provider, alternate;
+	tage_lookup(p, pc, history, index, provider, alternate);
+	bool base = p.counters[pc & mask] >= 2;
+	bool alternate_taken = alternate != -1 ? p.tagged[(alternate << p.index_bits) + index[alternate]].counter >= 0 : base;
+	bool predicted = base;
+	if (provider != -1)
+	{
+		tage_entry &entry = p.tagged[(provider << p.index_bits) + index[provider]];
+		predicted = entry.counter >= 0;
+		if (predicted != alternate_taken) // the entry made the difference: it is useful if it was right
+		{
+			if (predicted == taken && entry.useful < 3)
+			{
+				entry.useful++;
+				p.updates++;
+			}
+			else if (predicted != taken && entry.useful > 0)
+			{
+				entry.useful--;
+				p.updates++;
+			}
+		}
+		if (taken && entry.counter < 3)
+		{
+			entry.counter++;
+			p.updates++;
+		}
+		else if (!taken && entry.counter > -4)
+		{
+			entry.counter--;
+			p.updates++;
+		}
+	}
+	else
+	{
+		train_counter(p.counters[pc & mask], taken, p.updates);
+	}
+
+	// on a misprediction, an entry is allocated in a table with a longer history than the provider's
+	if (predicted != taken && provider < TAGE_TABLES - 1)
+	{
+		bool allocated = false;
+		for (int t = provider + 1; t < TAGE_TABLES && !allocated; t++)
+		{
+			tage_entry &entry = p.tagged[(t << p.index_bits) + index[t]];
+			if (entry.useful == 0)
+			{
+				entry.tag = tage_tag(t, pc, history);
+				entry.counter = taken ? 0 : -1;
+				allocated = true;
+				p.updates++;
+			}
+		}
+		for (int t = provider + 1; t < TAGE_TABLES && !allocated; t++) // none free: make room for the next time
+		{
+			tage_entry &entry = p.tagged[(t << p.index_bits) + index[t]];
+			if (entry.useful > 0)
+			{
+				entry.useful--;
+				p.updates++;
+			}
+		}
+	}
+}
+
+/* returns true and the target of the branch at word "pc" if the BTB holds it; targets are static, so a hit is always right */
+static bool btb_lookup(const branch_predictor &p, unsigned pc, unsigned &target)
+{
+	unsigned slot = pc & (p.btb_size - 1);
+	if (p.btb_pc[slot] != pc)
+	{
+		return false;
+	}
+	target = p.btb_target[slot];
+	return true;
+}
+
+/* trains the predictor with a committed branch (or jump if not "conditional") at word "pc" */
+static void train_predictor(branch_predictor &p, unsigned pc, bool conditional, unsigned long long history, bool taken,
+	unsigned target)
+{
+	if (conditional)
+	{
+		train_direction(p, pc, history, taken);
+		if (p.kind != PREDICT_BIMODAL)
+		{
+			p.retired_history = (p.retired_history << 1) | taken;
+		}
+	}
+	unsigned slot = pc & (p.btb_size - 1);
+	if (taken && p.btb_pc[slot] != pc)
+	{
+		p.btb_pc[slot] = pc;
+		p.btb_target[slot] = target;
+		p.updates++;
+	}
 }
 
 sim_ooo::sim_ooo(unsigned mem_size,
@@ -123,7 +512,8 @@ sim_ooo::sim_ooo(unsigned mem_size,
                 unsigned num_add_res_stations,
                 unsigned num_mul_res_stations,
                 unsigned num_load_res_stations,
-		unsigned max_issue){
+		unsigned max_issue,
+		unsigned max_commit){
 	//memory
 	data_memory_size = mem_size;
 	data_memory = new unsigned char[data_memory_size];
@@ -134,15 +524,72 @@ sim_ooo::sim_ooo(unsigned mem_size,
 
 	//fill here
 	issue_max = max_issue;
+	commit_max = max_commit != 0 ? max_commit : 1;
+	commit_width_limited = 0;
+	commit_head_blocked = 0;
+	pc = 0;
+	base_Address = 0;
+	instruction_memory = NULL;
+	decoded_memory = NULL;
+	decoded_memory_size = 0;
+	decoded_memory_end = 0;
+	instruction_memory_size = 0;
+	eop = false;
+	stalled = false;
+	stalls = 0;
+	sample_count = 0;
+	sample_cpi_sum = 0;
+	sample_cpi_square_sum = 0;
+	final_pc = UNDEFINED;
+
+	loop_extrapolation = false;
+	loop_edge = false;
+	loop_body = new unsigned[LOOP_MAX_BODY];
+	loop_last_body = new unsigned[LOOP_MAX_BODY];
+	loop_body_length = loop_last_length = UNDEFINED;
+	loop_fingerprint = 0;
+	loop_edge_cycles = loop_edge_stalls = 0;
+	loop_delta_cycles = loop_delta_stalls = 0;
+	loop_edge_limited = loop_edge_blocked = 0;
+	loop_delta_limited = loop_delta_blocked = 0;
+	loop_edge_branches = loop_edge_mispredictions = loop_edge_btb_misses = loop_edge_updates = 0;
+	loop_delta_branches = loop_delta_mispredictions = loop_delta_btb_misses = 0;
+	loop_edge_checkpoint_stalls = loop_delta_checkpoint_stalls = 0;
+	loop_edge_forwarded = loop_edge_conflicts = loop_delta_forwarded = loop_delta_conflicts = 0;
+	extrapolations = extrapolated_iterations = extrapolated_instructions = extrapolated_cycles = 0;
+
+	front = NULL;
+	rob_trace = NULL;
+	predictor = NULL;
+	branches = mispredictions = btb_misses = 0;
+	early_resolution = false;
+	resolved_entry = UNDEFINED;
+	store_logging = false;
+	store_log = NULL;
+	store_log_length = store_log_capacity = 0;
+
+	//execution units are allocated by init_exec_unit
+	int_ex = add_ex = mult_ex = div_ex = mem_ex = NULL;
+	wheel = NULL;
+	wheel_size = 0;
+	releasing = NULL;
+	size_of_int_ex = size_of_add_ex = size_of_mult_ex = size_of_div_ex = size_of_mem_ex = 0;
 
 	int_reg = new int_register[NUM_GP_REGISTERS];
 	fp_reg = new fp_register[NUM_GP_REGISTERS];
 	reset();
 
-	int_rs = new reservation_station[num_int_res_stations];
-	add_rs = new reservation_station[num_add_res_stations];
-	mult_rs = new reservation_station[num_mul_res_stations];
-	load_rs = new reservation_station[num_load_res_stations];
+	//all stations live in one block so that a station can be named by its index in it
+	all_rs = new reservation_station[num_int_res_stations + num_add_res_stations + num_mul_res_stations + num_load_res_stations];
+	int_rs = all_rs;
+	add_rs = int_rs + num_int_res_stations;
+	mult_rs = add_rs + num_add_res_stations;
+	load_rs = mult_rs + num_mul_res_stations;
+	unsigned total_rs = num_int_res_stations + num_add_res_stations + num_mul_res_stations + num_load_res_stations;
+	ready_words = (total_rs + 63) / 64;
+	ready_rs = new unsigned long long[NUM_EXE_UNITS * ready_words];
+	touched_rs = new unsigned[total_rs];
+	touched_count = 0;
 
 	size_of_int_rs = num_int_res_stations;
 	size_of_add_rs = num_add_res_stations;
@@ -172,14 +619,48 @@ sim_ooo::sim_ooo(unsigned mem_size,
 
 	rob = new read_order_buffer[rob_size];
 	size_of_rob = rob_size;
+	retired_entries = new unsigned[rob_size];
+	rename_map = new unsigned[rob_size * 2 * NUM_GP_REGISTERS];
+	rename_checkpoints = rob_size;
+	checkpoint_stalls = 0;
+	forwarded_loads = memory_conflicts = 0;
+	rob_seq = 0;
 	iq = new instruction_q[size_of_rob];
 	flush_rob();
+	flush_rs();
+	il = NULL;
 	instruction_log_length = 0;
+	instruction_log_capacity = 0;
+	instruction_log_limit = UNDEFINED_LOG;
 }
 	
 sim_ooo::~sim_ooo()
 {
-	delete(data_memory);
+	stop_functional_front();
+	delete[] data_memory;
+	delete[] instruction_memory;
+	delete[] decoded_memory;
+	delete[] all_rs;
+	delete[] ready_rs;
+	delete[] touched_rs;
+	delete[] int_ex;
+	delete[] add_ex;
+	delete[] mult_ex;
+	delete[] div_ex;
+	delete[] mem_ex;
+	delete[] wheel;
+	delete[] rob;
+	delete[] retired_entries;
+	delete[] rename_map;
+	delete[] int_reg;
+	delete[] fp_reg;
+	delete[] iq;
+	delete[] il;
+	delete[] rob_trace;
+	delete[] loop_body;
+	delete[] loop_last_body;
+	delete[] store_log;
+	delete_predictor(predictor);
 }
 
 void sim_ooo::init_exec_unit(exe_unit_t exec_unit, unsigned latency, unsigned instances)
@@ -190,54 +671,71 @@ void sim_ooo::init_exec_unit(exe_unit_t exec_unit, unsigned latency, unsigned in
 	{
 	case INTEGER:
 		unit_name = "INT";
+		delete[] int_ex;
 		int_ex = new ex_unit[instances];
 		size_of_int_ex = instances;
 		break;
 	case ADDER:
 		unit_name = "ADD";
+		delete[] add_ex;
 		add_ex = new ex_unit[instances];
 		size_of_add_ex = instances;
 		break;
 	case MULTIPLIER:
 		unit_name = "MULT";
+		delete[] mult_ex;
 		mult_ex = new ex_unit[instances];
 		size_of_mult_ex = instances;
 		break;
 	case DIVIDER:
 		unit_name = "DIV";
+		delete[] div_ex;
 		div_ex = new ex_unit[instances];
 		size_of_div_ex = instances;
 		break;
 	case MEMORY:
 		unit_name = "MEM";
+		delete[] mem_ex;
 		mem_ex = new ex_unit[instances];
 		size_of_mem_ex = instances;
 		break;
 	}
 
+	// the timing wheel must have more slots than the longest latency so that slots never wrap onto in-flight units
+	if (latency + 2 > wheel_size)
+	{
+		unsigned new_size = wheel_size == 0 ? 16 : wheel_size;
+		while (new_size < latency + 2)
+		{
+			new_size *= 2;
+		}
+		delete[] wheel;
+		wheel = new ex_unit*[new_size];
+		wheel_size = new_size;
+		for (unsigned i = 0; i < wheel_size; i++)
+		{
+			wheel[i] = NULL;
+		}
+	}
+
 	for(unsigned i = 0; i < instances; i++)
 	{
 		switch (exec_unit)
 		{
 		case INTEGER:
-			int_ex[i].name = unit_name + to_string(i+1);
-			int_ex[i].delay = latency+1;
+			int_ex[i] = clear_ex_unit(unit_name + to_string(i+1), latency+1, INTEGER);
 			break;
 		case ADDER:
-			add_ex[i].name = unit_name + to_string(i+1);
-			add_ex[i].delay = latency+1;
+			add_ex[i] = clear_ex_unit(unit_name + to_string(i+1), latency+1, ADDER);
 			break;
 		case MULTIPLIER:
-			mult_ex[i].name = unit_name + to_string(i+1);
-			mult_ex[i].delay = latency+1;
+			mult_ex[i] = clear_ex_unit(unit_name + to_string(i+1), latency+1, MULTIPLIER);
 			break;
 		case DIVIDER:
-			div_ex[i].name = unit_name + to_string(i+1);
-			div_ex[i].delay = latency+1;
+			div_ex[i] = clear_ex_unit(unit_name + to_string(i+1), latency+1, DIVIDER);
 			break;
 		case MEMORY:
-			mem_ex[i].name = unit_name + to_string(i+1);
-			mem_ex[i].delay = latency+1;
+			mem_ex[i] = clear_ex_unit(unit_name + to_string(i+1), latency+1, MEMORY);
 			break;
 		}
 	}
@@ -246,6 +744,8 @@ void sim_ooo::init_exec_unit(exe_unit_t exec_unit, unsigned latency, unsigned in
 
 void sim_ooo::load_program(const char *filename, unsigned base_address)
 {
+	stop_functional_front(); // the front reads the decoded program
+	delete[] instruction_memory;
 	instruction_memory = new unsigned int[base_address + 100];
 	for (unsigned i = 0; i<base_address + 100; i++)
 	{
@@ -552,6 +1052,7 @@ void sim_ooo::load_program(const char *filename, unsigned base_address)
 		}
 		pc = base_address;
 		program.close();
+		decode_instruction_memory(base_address + 100);
 
 	}
 	else
@@ -561,12 +1062,116 @@ void sim_ooo::load_program(const char *filename, unsigned base_address)
 	}
 }
 
-void sim_ooo::run(unsigned cycles)
+void sim_ooo::decode_instruction_memory(unsigned size)
+{
+	delete[] decoded_memory;
+	decoded_memory = new decoded_instruction[size];
+	decoded_memory_size = size;
+	decoded_memory_end = 0;
+	for (unsigned i = 0; i < size; i++)
+	{
+		unsigned word = instruction_memory[i];
+		decoded_instruction &inst = decoded_memory[i];
+		inst.opcode = (word >> 26) & 31;
+		inst.station = 0;
+		inst.unit = 0;
+		inst.int_or_float = true;
+		inst.dest = UNDEFINED;
+		inst.src1 = UNDEFINED;
+		inst.src2 = UNDEFINED;
+		inst.imm = UNDEFINED;
+		inst.target = UNDEFINED;
+
+		switch (inst.opcode)
+		{
+		case LWS:
+		case SWS:
+			inst.int_or_float = false;
+		case LW:
+		case SW:
+			inst.station = LOAD_B;
+			inst.unit = MEMORY;
+			inst.dest = (word >> 21) & 31;
+			inst.src1 = word & 31;
+			inst.imm = (word >> 5) & 65535;
+			break;
+		case ADDS:
+		case SUBS:
+			inst.int_or_float = false;
+			inst.station = ADD_RS;
+			inst.unit = ADDER;
+			inst.dest = (word >> 21) & 31;
+			inst.src1 = (word >> 16) & 31;
+			inst.src2 = (word >> 11) & 31;
+			break;
+		case MULTS:
+		case DIVS:
+			inst.int_or_float = false;
+		case MULT:
+		case DIV:
+			inst.station = MULT_RS;
+			inst.unit = (inst.opcode == MULT || inst.opcode == MULTS) ? MULTIPLIER : DIVIDER;
+			inst.dest = (word >> 21) & 31;
+			inst.src1 = (word >> 16) & 31;
+			inst.src2 = (word >> 11) & 31;
+			break;
+		case ADD:
+		case SUB:
+		case XOR:
+		case OR:
+		case AND:
+			inst.station = INTEGER_RS;
+			inst.unit = INTEGER;
+			inst.dest = (word >> 21) & 31;
+			inst.src1 = (word >> 16) & 31;
+			inst.src2 = (word >> 11) & 31;
+			break;
+		case ADDI:
+		case SUBI:
+		case XORI:
+		case ORI:
+		case ANDI:
+			inst.station = INTEGER_RS;
+			inst.unit = INTEGER;
+			inst.dest = (word >> 21) & 31;
+			inst.src1 = (word >> 16) & 31;
+			inst.imm = word & 65535;
+			break;
+		case BEQZ:
+		case BNEZ:
+		case BLTZ:
+		case BGTZ:
+		case BLEZ:
+		case BGEZ:
+			inst.station = INTEGER_RS;
+			inst.unit = INTEGER;
+			inst.src1 = (word >> 21) & 31;
+			inst.target = (word & 65535) + base_Address;
+			break;
+		case JUMP:
+			inst.station = INTEGER_RS;
+			inst.unit = INTEGER;
+			inst.target = (word & 65535) + base_Address;
+			break;
+		case EOP:
+			inst.station = INTEGER_RS;
+			inst.unit = INTEGER;
+			break;
+		}
+		if (inst.station != 0)
+		{
+			decoded_memory_end = i + 1;
+		}
+	}
+}
+
+void sim_ooo::run(unsigned long long cycles)
 {
 	if (cycles == 0)
 	{
 		while (!eop)
 		{
+			skip_idle_cycles(UNDEFINED_CYCLE);
 			commit();
 			if (eop)
 			{
@@ -577,13 +1182,22 @@ void sim_ooo::run(unsigned cycles)
 			execute();
 			issue();
 			clock_cycles++;
+			if (loop_edge)
+			{
+				end_loop_iteration(true);
+			}
 		}
 	}
 	else //run for select amount of cycles
 	{
-		unsigned i;
+		unsigned long long i;
 		for (i = 0; i<cycles; i++)
 		{
+			i += skip_idle_cycles(cycles - i);
+			if (i == cycles)
+			{
+				break;
+			}
 			commit();
 			if (eop)
 			{
@@ -594,6 +1208,10 @@ void sim_ooo::run(unsigned cycles)
 			execute();
 			issue();
 			clock_cycles++;
+			if (loop_edge)
+			{
+				end_loop_iteration(false); // the cycle budget leaves no room for extrapolated cycles
+			}
 			if (eop)
 			{
 				break;
@@ -602,2437 +1220,5064 @@ void sim_ooo::run(unsigned cycles)
 	}
 }
 
-//reset the state of the sim_oooulator
-void sim_ooo::reset()
+bool sim_ooo::finished()
 {
-	//Add reset for reservation stations
-	for (int i = 0; i < NUM_GP_REGISTERS; i++)
-	{
-		int_reg[i].value = UNDEFINED;
-		int_reg[i].entry = UNDEFINED;
-		fp_reg[i].value = (float)(UNDEFINED);
-		fp_reg[i].entry = UNDEFINED;
-	}
-	clock_cycles = 0;
-	instruction_count = 0;
+	return eop;
 }
 
-int sim_ooo::get_int_register(unsigned reg)
+/* executes "inst", found at word "pc", on the architectural state "r", "f" and "memory" and records its outcome in "record";
+   returns false, without executing it, for EOP, a load or store outside memory and an integer divide by zero */
+static bool execute_functional(const decoded_instruction &inst, unsigned pc, int *r, float *f,
+	unsigned char *memory, unsigned memory_size, dynamic_instruction &record)
 {
-	unsigned rob_entry = get_pending_int_register(reg);
-	if (rob_entry != UNDEFINED)
+	int vj = inst.src1 != UNDEFINED ? r[inst.src1] : 0;
+	int vk = inst.src2 != UNDEFINED ? r[inst.src2] : (int)inst.imm;
+	record.pc = pc * 4;
+	record.next_pc = pc + 1;
+	record.address = UNDEFINED;
+	record.taken = false;
+	switch (inst.opcode)
 	{
-		if (rob[rob_entry].ready)
+	case LW:
+	case LWS:
+	case SW:
+	case SWS:
+		record.address = vj + inst.imm;
+		if (record.address > memory_size || memory_size - record.address < 4)
 		{
-			return rob[rob_entry].value;
+			return false;
 		}
-		else
+		if (inst.opcode == LW)
 		{
-			return UNDEFINED;
+			record.value = r[inst.dest] = char2unsigned(memory + record.address);
 		}
-	}
-	return int_reg[reg].value;
-}
-
-void sim_ooo::set_int_register(unsigned reg, int value)
-{
-	int_reg[reg].value = value;
-}
-
-float sim_ooo::get_fp_register(unsigned reg)
-{
-	unsigned rob_entry = get_pending_fp_register(reg);
-	if (rob_entry != UNDEFINED)
-	{
-		if (rob[rob_entry].ready)
+		else if (inst.opcode == LWS)
 		{
-			return rob[rob_entry].value_f;
+			record.value_f = f[inst.dest] = unsigned2float(char2unsigned(memory + record.address));
+			record.value = float2unsigned(record.value_f);
 		}
 		else
 		{
-			return unsigned2float(UNDEFINED);
+			unsigned2char(inst.opcode == SW ? r[inst.dest] : float2unsigned(f[inst.dest]), memory + record.address);
+			record.value = record.address;
 		}
-	}
-	
-	return fp_reg[reg].value;
-}
-
-void sim_ooo::set_fp_register(unsigned reg, float value)
-{
-	fp_reg[reg].value = value;
-}
-
-unsigned sim_ooo::get_pending_int_register(unsigned reg)
-{
-	unsigned index = UNDEFINED;
-	unsigned size = size_of_rob;
-	for (unsigned i = 0; i < size; i++)
-	{
-		if (rob[i].destination == ("R" + to_string(reg)))
+		break;
+	case ADD:
+	case ADDI:
+		record.value = r[inst.dest] = vj + vk;
+		break;
+	case SUB:
+	case SUBI:
+		record.value = r[inst.dest] = vj - vk;
+		break;
+	case XOR:
+	case XORI:
+		record.value = r[inst.dest] = vj ^ vk;
+		break;
+	case OR:
+	case ORI:
+		record.value = r[inst.dest] = vj | vk;
+		break;
+	case AND:
+	case ANDI:
+		record.value = r[inst.dest] = vj & vk;
+		break;
+	case MULT:
+		record.value = r[inst.dest] = vj * vk;
+		break;
+	case DIV:
+		if (vk == 0)
 		{
-			index = i;
+			return false;
 		}
-	}
-	return index;
-}
-
-unsigned sim_ooo::get_pending_fp_register(unsigned reg)
+		record.value = r[inst.dest] = vj / vk;
+		break;
+	case ADDS:
+		record.value_f = f[inst.dest] = f[inst.src1] + f[inst.src2];
+		break;
+	case SUBS:
+		record.value_f = f[inst.dest] = f[inst.src1] - f[inst.src2];
+		break;
+	case MULTS:
+		record.value_f = f[inst.dest] = f[inst.src1] * f[inst.src2];
+		break;
+	case DIVS:
+		record.value_f = f[inst.dest] = f[inst.src1] / f[inst.src2];
+		break;
+	case BEQZ:
+	case BNEZ:
+	case BLTZ:
+	case BGTZ:
+	case BLEZ:
+	case BGEZ:
+		record.taken = (inst.opcode == BEQZ && vj == 0) || (inst.opcode == BNEZ && vj != 0)
+			|| (inst.opcode == BLTZ && vj < 0) || (inst.opcode == BGTZ && vj > 0)
+			|| (inst.opcode == BLEZ && vj <= 0) || (inst.opcode == BGEZ && vj >= 0);
+		if (record.taken)
+		{
+			record.next_pc = inst.target;
+		}
+		record.value = record.next_pc * 4 + (record.taken ? 4 : 0); // same encoding as compute_result_int
+		break;
+	case JUMP:
+		record.taken = true;
+		record.next_pc = inst.target;
+		record.value = inst.target * 4 + 4;
+		break;
+	default: // EOP
+		return false;
+	}
+	if (inst.opcode == ADDS || inst.opcode == SUBS || inst.opcode == MULTS || inst.opcode == DIVS)
+	{
+		record.value = float2unsigned(record.value_f);
+	}
+	return true;
+}
+
+unsigned long long sim_ooo::fast_forward(unsigned long long instructions)
 {
-	unsigned index = UNDEFINED;
-	unsigned size = size_of_rob;
-	for (unsigned i = 0; i < size; i++)
+	stop_functional_front(); // the front's stream would no longer match the program order
+	loop_body_length = loop_last_length = UNDEFINED; // the current iteration is not simulated in full
+	if (eop)
+	{
+		return 0;
+	}
+	// architectural state is the committed state: squash everything in flight and resume at the oldest instruction
+	if (rob_count != 0)
+	{
+		pc = rob[rob_head].pc / 4;
+		flush_rob();
+		flush_ex();
+		flush_rs();
+	}
+	int r[NUM_GP_REGISTERS];
+	float f[NUM_GP_REGISTERS];
+	for (unsigned i = 0; i < NUM_GP_REGISTERS; i++)
 	{
-		if (rob[i].destination == ("F" + to_string(reg)))
+		int_reg[i].entry = UNDEFINED;
+		fp_reg[i].entry = UNDEFINED;
+		r[i] = int_reg[i].value;
+		f[i] = fp_reg[i].value;
+	}
+
+	unsigned long long executed = 0;
+	dynamic_instruction record;
+	while (executed < instructions && pc < decoded_memory_end)
+	{
+		const decoded_instruction &inst = decoded_memory[pc];
+		if (inst.station == 0) // empty word, skipped by issue as well
 		{
-			index = i;
+			pc++;
+			continue;
+		}
+		if (!execute_functional(inst, pc, r, f, data_memory, data_memory_size, record))
+		{
+			break;
+		}
+		if (predictor != NULL && inst.target != UNDEFINED) // the predictor is kept warm
+		{
+			train_predictor(*predictor, pc, inst.opcode != JUMP, predictor->retired_history, record.taken, record.next_pc);
 		}
+		pc = record.next_pc;
+		executed++;
 	}
-	return index;
+	if (predictor != NULL)
+	{
+		predictor->history = predictor->retired_history;
+	}
+
+	for (unsigned i = 0; i < NUM_GP_REGISTERS; i++)
+	{
+		int_reg[i].value = r[i];
+		fp_reg[i].value = f[i];
+	}
+	return executed;
 }
 
-void sim_ooo::print_status(){
-	print_pending_instructions();
-	print_rob();
-	print_reservation_stations();
-	print_registers();
+//predicts a field of the next record of one static instruction from its last value and stride
+struct stride_predictor
+{
+	unsigned last;
+	unsigned stride;
+};
+
+//buffers one block of a trace being captured
+struct trace_writer
+{
+	ostream *out;
+	stride_predictor *addresses; //one per instruction word
+	stride_predictor *values;
+	unsigned records; //in the current block
+	unsigned bit_count;
+	unsigned byte_count;
+	unsigned char bits[TRACE_BLOCK * 2 / 8]; //branch outcomes and prediction hits, at most two per record
+	unsigned char bytes[TRACE_BLOCK * 10]; //varints of the mispredicted fields, at most two per record
+};
+
+//decodes the blocks of a replayed trace straight from the mapped file
+struct trace_reader
+{
+	const decoded_instruction *program;
+	unsigned program_end;
+	unsigned pc; //word of the next record
+	stride_predictor *addresses;
+	stride_predictor *values;
+	const unsigned char *map;
+	size_t map_size;
+	size_t offset; //start of the next block
+	const unsigned char *bits;
+	unsigned bit_count;
+	unsigned bit_index;
+	const unsigned char *bytes;
+	const unsigned char *bytes_end;
+	unsigned records; //left in the current block
+	bool failed; //a block overran its own size
+};
+
+/* trace records are not stored as they are: the pc follows from the program and the branch outcomes, a store's
+   value is its address, and addresses and results are predicted from the last value and stride of the same
+   instruction. A correct prediction costs one bit; otherwise the difference is stored as a zigzag varint */
+static void put_bit(trace_writer &writer, bool bit)
+{
+	if (bit)
+	{
+		writer.bits[writer.bit_count / 8] |= 1 << (writer.bit_count % 8);
+	}
+	writer.bit_count++;
 }
 
-void sim_ooo::print_memory(unsigned start_address, unsigned end_address){
-	cout << "DATA MEMORY[0x" << hex << setw(8) << setfill('0') << start_address << ":0x" << hex << setw(8) << setfill('0') <<  end_address << "]" << endl;
-	for (unsigned i=start_address; i<end_address; i++){
-		if (i%4 == 0) cout << "0x" << hex << setw(8) << setfill('0') << i << ": "; 
-		cout << hex << setw(2) << setfill('0') << int(data_memory[i]) << " ";
-		if (i%4 == 3){
-			cout << endl;
+static void put_field(trace_writer &writer, stride_predictor &predictor, unsigned value)
+{
+	unsigned delta = value - (predictor.last + predictor.stride);
+	put_bit(writer, delta == 0);
+	if (delta != 0)
+	{
+		unsigned zigzag = (delta << 1) ^ (0u - (delta >> 31));
+		while (zigzag >= 0x80)
+		{
+			writer.bytes[writer.byte_count++] = (zigzag & 0x7F) | 0x80;
+			zigzag >>= 7;
 		}
-	} 
+		writer.bytes[writer.byte_count++] = zigzag;
+	}
+	predictor.stride = value - predictor.last;
+	predictor.last = value;
 }
 
-void sim_ooo::write_memory(unsigned address, unsigned value)
+static bool get_bit(trace_reader &reader)
 {
-	unsigned2char(value,data_memory+address);
+	if (reader.bit_index >= reader.bit_count)
+	{
+		reader.failed = true;
+		return false;
+	}
+	bool bit = (reader.bits[reader.bit_index / 8] >> (reader.bit_index % 8)) & 1;
+	reader.bit_index++;
+	return bit;
 }
 
-void sim_ooo::print_registers(){
-        unsigned i;
-	cout << "GENERAL PURPOSE REGISTERS" << endl;
-	cout << setfill(' ') << setw(8) << "Register" << setw(22) << "Value" << setw(5) << "ROB" << endl;
-        for (i=0; i< NUM_GP_REGISTERS; i++){
-                if (get_pending_int_register(i)!=UNDEFINED) 
-			cout << setfill(' ') << setw(7) << "R" << dec << i << setw(22) << "-" << setw(5) << int_reg[i].entry << endl;
-                else if (get_int_register(i)!=(int)UNDEFINED) 
-			cout << setfill(' ') << setw(7) << "R" << dec << i << setw(11) << get_int_register(i) << hex << "/0x" << setw(8) << setfill('0') << get_int_register(i) << setfill(' ') << setw(5) << "-" << endl;
-        }
-	for (i=0; i< NUM_GP_REGISTERS; i++){
-                if (get_pending_fp_register(i)!=UNDEFINED) 
-			cout << setfill(' ') << setw(7) << "F" << dec << i << setw(22) << "-" << setw(5) << fp_reg[i].entry << endl;
-                else if (get_fp_register(i)!=UNDEFINED) 
-			cout << setfill(' ') << setw(7) << "F" << dec << i << setw(11) << get_fp_register(i) << hex << "/0x" << setw(8) << setfill('0') << float2unsigned(get_fp_register(i)) << setfill(' ') << setw(5) << "-" << endl;
+static unsigned get_field(trace_reader &reader, stride_predictor &predictor)
+{
+	unsigned value = predictor.last + predictor.stride;
+	if (!get_bit(reader))
+	{
+		unsigned zigzag = 0;
+		for (unsigned shift = 0; ; shift += 7)
+		{
+			if (reader.bytes == reader.bytes_end || shift > 28)
+			{
+				reader.failed = true;
+				break;
+			}
+			unsigned char byte = *reader.bytes++;
+			zigzag |= (unsigned)(byte & 0x7F) << shift;
+			if ((byte & 0x80) == 0)
+			{
+				break;
+			}
+		}
+		value += (zigzag >> 1) ^ (0u - (zigzag & 1));
 	}
-	cout << endl;
+	predictor.stride = value - predictor.last;
+	predictor.last = value;
+	return value;
 }
 
-void sim_ooo::print_rob(){
-	cout << "REORDER BUFFER" << endl; 
-	cout << setfill(' ') << setw(5) << "Entry" << setw(6) << "Busy" << setw(7) << "Ready" << setw(12) << "PC" << setw(10) << "State" << setw(6) << "Dest" << setw(12) << "Value" << endl;
-	
-	//fill here
-	unsigned size = size_of_rob;
-	string busy, ready, state, dest;
-	bool good_pc, good_value;
-	for (unsigned i = 0; i < size; i++)
-	{		
-		if (rob[i].busy)
+/* a block is its number of records, the sizes of its bit and byte streams, and the two streams */
+static void flush_trace_block(trace_writer &writer)
+{
+	if (writer.records == 0)
+	{
+		return;
+	}
+	unsigned bit_bytes = (writer.bit_count + 7) / 8;
+	write_u32(*writer.out, writer.records);
+	write_u32(*writer.out, bit_bytes);
+	write_u32(*writer.out, writer.byte_count);
+	writer.out->write((const char *)writer.bits, bit_bytes);
+	writer.out->write((const char *)writer.bytes, writer.byte_count);
+	memset(writer.bits, 0, bit_bytes);
+	writer.records = 0;
+	writer.bit_count = 0;
+	writer.byte_count = 0;
+}
+
+static void write_trace_record(trace_writer &writer, const decoded_instruction &inst, const dynamic_instruction &record)
+{
+	unsigned pc = record.pc / 4;
+	switch (inst.opcode)
+	{
+	case BEQZ:
+	case BNEZ:
+	case BLTZ:
+	case BGTZ:
+	case BLEZ:
+	case BGEZ:
+		put_bit(writer, record.taken);
+		break;
+	case JUMP:
+		break;
+	case LW:
+	case LWS:
+		put_field(writer, writer.addresses[pc], record.address);
+		put_field(writer, writer.values[pc], record.value);
+		break;
+	case SW:
+	case SWS:
+		put_field(writer, writer.addresses[pc], record.address);
+		break;
+	default:
+		put_field(writer, writer.values[pc], record.value);
+	}
+	if (++writer.records == TRACE_BLOCK)
+	{
+		flush_trace_block(writer);
+	}
+}
+
+static bool next_trace_block(trace_reader &reader)
+{
+	if (reader.map_size - reader.offset < 12)
+	{
+		return false;
+	}
+	unsigned char *header = (unsigned char *)reader.map + reader.offset;
+	unsigned records = char2unsigned(header);
+	unsigned bit_bytes = char2unsigned(header + 4);
+	unsigned byte_count = char2unsigned(header + 8);
+	reader.offset += 12;
+	if (records == 0 || bit_bytes > reader.map_size - reader.offset
+		|| byte_count > reader.map_size - reader.offset - bit_bytes)
+	{
+		return false;
+	}
+	reader.records = records;
+	reader.bits = reader.map + reader.offset;
+	reader.bit_count = bit_bytes * 8;
+	reader.bit_index = 0;
+	reader.bytes = reader.bits + bit_bytes;
+	reader.bytes_end = reader.bytes + byte_count;
+	reader.offset += bit_bytes + byte_count;
+	return true;
+}
+
+/* decodes the next record, following the program from the previous one; false at the end of the file */
+static bool read_trace_record(trace_reader &reader, dynamic_instruction &record)
+{
+	if (reader.records == 0 && !next_trace_block(reader))
+	{
+		return false;
+	}
+	while (reader.pc < reader.program_end && reader.program[reader.pc].station == 0)
+	{
+		reader.pc++;
+	}
+	if (reader.pc >= reader.program_end)
+	{
+		return false;
+	}
+	const decoded_instruction &inst = reader.program[reader.pc];
+	record.pc = reader.pc * 4;
+	record.next_pc = reader.pc + 1;
+	record.address = UNDEFINED;
+	record.taken = false;
+	switch (inst.opcode)
+	{
+	case BEQZ:
+	case BNEZ:
+	case BLTZ:
+	case BGTZ:
+	case BLEZ:
+	case BGEZ:
+		record.taken = get_bit(reader);
+		if (record.taken)
 		{
-			busy = "yes";
+			record.next_pc = inst.target;
 		}
-		else
+		record.value = record.next_pc * 4 + (record.taken ? 4 : 0);
+		break;
+	case JUMP:
+		record.taken = true;
+		record.next_pc = inst.target;
+		record.value = inst.target * 4 + 4;
+		break;
+	case LW:
+	case LWS:
+		record.address = get_field(reader, reader.addresses[reader.pc]);
+		record.value = get_field(reader, reader.values[reader.pc]);
+		break;
+	case SW:
+	case SWS:
+		record.address = get_field(reader, reader.addresses[reader.pc]);
+		record.value = record.address;
+		break;
+	case EOP:
+		return false;
+	default:
+		record.value = get_field(reader, reader.values[reader.pc]);
+	}
+	record.value_f = unsigned2float(record.value);
+	reader.pc = record.next_pc;
+	reader.records--;
+	return !reader.failed;
+}
+
+static void close_trace(trace_reader *reader)
+{
+	if (reader == NULL)
+	{
+		return;
+	}
+	munmap((void *)reader->map, reader->map_size);
+	delete[] reader->addresses;
+	delete[] reader->values;
+	delete reader;
+}
+
+/* refills the empty ring of a replayed trace with the next records of the file */
+static void read_trace_records(functional_front *front)
+{
+	unsigned long long tail = front->tail.load(memory_order_relaxed);
+	unsigned count = 0;
+	while (count < FRONT_RING_SIZE && front->trace_left > 0)
+	{
+		if (!read_trace_record(*front->trace, front->ring[(tail + count) & (FRONT_RING_SIZE - 1)]))
 		{
-			busy = "no";
+			front->trace_left = 0; // truncated file
+			break;
 		}
-		if (rob[i].ready)
+		count++;
+		front->trace_left--;
+	}
+	front->tail.store(tail + count, memory_order_release);
+	if (front->trace_left == 0)
+	{
+		front->done.store(true, memory_order_release);
+	}
+}
+
+/* body of the functional front thread: executes the program and publishes one record per instruction */
+static void run_functional_front(functional_front *front)
+{
+	dynamic_instruction record;
+	while (front->pc < front->program_end)
+	{
+		const decoded_instruction &inst = front->program[front->pc];
+		if (inst.station == 0) // empty word, skipped by issue as well
 		{
-			ready = "yes";
+			front->pc++;
+			continue;
 		}
-		else
+		if (!execute_functional(inst, front->pc, front->r, front->f, front->memory, front->memory_size, record))
 		{
-			ready = "no";
+			break; // EOP, or an instruction left to the timing model
 		}
-		if (rob[i].pc != UNDEFINED)
+		front->pc = record.next_pc;
+
+		unsigned long long tail = front->tail.load(memory_order_relaxed);
+		while (tail - front->head.load(memory_order_acquire) == FRONT_RING_SIZE) // ring is full
 		{
-			good_pc = true;
+			if (front->stop.load(memory_order_relaxed))
+			{
+				front->done.store(true, memory_order_release);
+				return;
+			}
+			this_thread::yield();
 		}
-		else
+		front->ring[tail & (FRONT_RING_SIZE - 1)] = record;
+		front->tail.store(tail + 1, memory_order_release);
+	}
+	front->done.store(true, memory_order_release);
+}
+
+void sim_ooo::start_functional_front()
+{
+	if (front != NULL || eop)
+	{
+		return;
+	}
+	fast_forward(0); // start from the committed state
+
+	delete[] rob_trace;
+	rob_trace = new dynamic_instruction[size_of_rob];
+	front = new functional_front;
+	front->stop = false;
+	front->done = false;
+	front->head = 0;
+	front->tail = 0;
+	for (unsigned i = 0; i < NUM_GP_REGISTERS; i++)
+	{
+		front->r[i] = int_reg[i].value;
+		front->f[i] = fp_reg[i].value;
+	}
+	front->memory_size = data_memory_size;
+	front->memory = new unsigned char[data_memory_size];
+	memcpy(front->memory, data_memory, data_memory_size);
+	front->pc = pc;
+	front->program = decoded_memory;
+	front->program_end = decoded_memory_end;
+	front->wrong_path = false;
+	front->trace = NULL;
+	front->trace_left = 0;
+	front->producer = thread(run_functional_front, front);
+}
+
+void sim_ooo::stop_functional_front()
+{
+	if (front == NULL)
+	{
+		return;
+	}
+	front->stop = true;
+	if (front->producer.joinable())
+	{
+		front->producer.join();
+	}
+	delete[] front->memory;
+	close_trace(front->trace);
+	delete front;
+	front = NULL;
+	fast_forward(0); // instructions in flight lose their records, so they are issued again
+}
+
+dynamic_instruction *sim_ooo::next_record(unsigned pc)
+{
+	if (front == NULL || front->wrong_path)
+	{
+		return NULL;
+	}
+	unsigned long long head = front->head.load(memory_order_relaxed);
+	if (front->trace != NULL && head == front->tail.load(memory_order_relaxed))
+	{
+		read_trace_records(front);
+	}
+	while (head == front->tail.load(memory_order_acquire)) // wait for the producer unless it has finished
+	{
+		if (front->done.load(memory_order_acquire) && head == front->tail.load(memory_order_acquire))
 		{
-			good_pc = false;
+			return NULL;
 		}
-		if (rob[i].state != "")
+		this_thread::yield();
+	}
+	dynamic_instruction *record = &front->ring[head & (FRONT_RING_SIZE - 1)];
+	return record->pc == pc * 4 ? record : NULL;
+}
+
+void sim_ooo::trace_issue(unsigned entry, unsigned pc)
+{
+	dynamic_instruction *record = next_record(pc);
+	if (record == NULL)
+	{
+		return;
+	}
+	rob_trace[entry] = *record; // copied before the slot is handed back to the producer
+	rob[entry].traced = true;
+	front->head.store(front->head.load(memory_order_relaxed) + 1, memory_order_release);
+	if (rob_trace[entry].taken != rob[entry].predicted_taken) // issue continues down the other path until the branch commits
+	{
+		front->wrong_path = true;
+	}
+}
+
+bool sim_ooo::capture_trace(const char *filename, unsigned long long instructions)
+{
+	ofstream out(filename, ios::out | ios::binary | ios::trunc);
+	if (!out.is_open())
+	{
+		return false;
+	}
+
+	// the program runs on a copy of the committed state, so the simulator itself is left untouched
+	unsigned start_pc = rob_count != 0 ? rob[rob_head].pc / 4 : pc;
+	int r[NUM_GP_REGISTERS];
+	float f[NUM_GP_REGISTERS];
+	for (unsigned i = 0; i < NUM_GP_REGISTERS; i++)
+	{
+		r[i] = int_reg[i].value;
+		f[i] = fp_reg[i].value;
+	}
+	unsigned char *memory = new unsigned char[data_memory_size];
+	memcpy(memory, data_memory, data_memory_size);
+
+	out.write(trace_magic, sizeof(trace_magic));
+	write_u32(out, TRACE_VERSION);
+	write_u32(out, base_Address);
+	write_u32(out, instruction_memory_size);
+	write_u32(out, decoded_memory_size);
+	for (unsigned i = 0; i < decoded_memory_size; i++)
+	{
+		write_u32(out, instruction_memory[i]);
+	}
+	write_u32(out, start_pc);
+	for (unsigned i = 0; i < NUM_GP_REGISTERS; i++)
+	{
+		write_u32(out, r[i]);
+		write_u32(out, float2unsigned(f[i]));
+	}
+	streampos count_position = out.tellp();
+	write_u64(out, 0); // number of records and whether the trace ends at EOP, filled in at the end
+	write_u32(out, 0);
+
+	trace_writer *writer = new trace_writer;
+	writer->out = &out;
+	writer->addresses = new stride_predictor[decoded_memory_size]();
+	writer->values = new stride_predictor[decoded_memory_size]();
+	writer->records = 0;
+	writer->bit_count = 0;
+	writer->byte_count = 0;
+	memset(writer->bits, 0, sizeof(writer->bits));
+
+	unsigned long long count = 0;
+	bool ends_at_eop = false;
+	dynamic_instruction record;
+	unsigned trace_pc = start_pc;
+	while ((instructions == 0 || count < instructions) && trace_pc < decoded_memory_end)
+	{
+		const decoded_instruction &inst = decoded_memory[trace_pc];
+		if (inst.station == 0)
 		{
-			state = rob[i].state;
+			trace_pc++;
+			continue;
 		}
-		else
+		if (!execute_functional(inst, trace_pc, r, f, memory, data_memory_size, record))
 		{
-			state = "-";
+			ends_at_eop = inst.opcode == EOP;
+			break;
 		}
-		if (rob[i].destination != "")
+		write_trace_record(*writer, inst, record);
+		trace_pc = record.next_pc;
+		count++;
+	}
+	flush_trace_block(*writer);
+	delete[] writer->addresses;
+	delete[] writer->values;
+	delete writer;
+	delete[] memory;
+
+	out.seekp(count_position);
+	write_u64(out, count);
+	write_u32(out, ends_at_eop);
+	out.close();
+	return !out.fail();
+}
+
+bool sim_ooo::replay_trace(const char *filename)
+{
+	stop_functional_front();
+	ifstream in(filename, ios::in | ios::binary);
+	char magic[sizeof(trace_magic)];
+	in.read(magic, sizeof(magic));
+	if (!in || memcmp(magic, trace_magic, sizeof(magic)) != 0 || read_u32(in) != TRACE_VERSION)
+	{
+		return false;
+	}
+
+	// the program comes from the trace, so no assembly is parsed
+	base_Address = read_u32(in);
+	instruction_memory_size = read_u32(in);
+	unsigned program_size = read_u32(in);
+	if (!in || program_size == 0)
+	{
+		return false;
+	}
+	delete[] instruction_memory;
+	instruction_memory = new unsigned int[program_size];
+	for (unsigned i = 0; i < program_size; i++)
+	{
+		instruction_memory[i] = read_u32(in);
+	}
+	decode_instruction_memory(program_size);
+	pc = read_u32(in);
+	for (unsigned i = 0; i < NUM_GP_REGISTERS; i++)
+	{
+		int_reg[i].value = read_u32(in);
+		int_reg[i].entry = UNDEFINED;
+		fp_reg[i].value = unsigned2float(read_u32(in));
+		fp_reg[i].entry = UNDEFINED;
+	}
+	unsigned long long count = read_u64(in);
+	bool ends_at_eop = read_u32(in) != 0;
+	if (!in)
+	{
+		return false;
+	}
+	size_t records_offset = in.tellg();
+	in.close();
+
+	// the records are decoded in place from a read-only mapping of the file
+	int fd = open(filename, O_RDONLY);
+	struct stat file_stat;
+	if (fd < 0 || fstat(fd, &file_stat) != 0)
+	{
+		if (fd >= 0)
 		{
-			dest = rob[i].destination;
+			close(fd);
 		}
-		else
+		return false;
+	}
+	void *map = mmap(NULL, file_stat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (map == MAP_FAILED)
+	{
+		return false;
+	}
+	trace_reader *reader = new trace_reader;
+	reader->program = decoded_memory;
+	reader->program_end = decoded_memory_end;
+	reader->pc = pc;
+	reader->addresses = new stride_predictor[decoded_memory_size]();
+	reader->values = new stride_predictor[decoded_memory_size]();
+	reader->map = (const unsigned char *)map;
+	reader->map_size = file_stat.st_size;
+	reader->offset = records_offset;
+	reader->records = 0;
+	reader->failed = false;
+
+	eop = false;
+	flush_rob();
+	flush_ex();
+	flush_rs();
+
+	delete[] rob_trace;
+	rob_trace = new dynamic_instruction[size_of_rob];
+	front = new functional_front;
+	front->stop = false;
+	front->done = count == 0;
+	front->head = 0;
+	front->tail = 0;
+	front->memory = NULL;
+	front->memory_size = 0;
+	front->wrong_path = false;
+	front->trace = reader;
+	front->trace_left = count;
+
+	run_instructions(count);
+	if (ends_at_eop)
+	{
+		run();
+	}
+	stop_functional_front();
+	return true;
+}
+
+void sim_ooo::run_instructions(unsigned long long instructions)
+{
+	unsigned long long target = instruction_count + instructions;
+	while (!eop && instruction_count < target)
+	{
+		run(1);
+	}
+}
+
+void sim_ooo::run_sampled(unsigned long long functional, unsigned long long warmup, unsigned long long measure)
+{
+	sample_count = 0;
+	sample_cpi_sum = 0;
+	sample_cpi_square_sum = 0;
+	if (measure == 0) // without a measurement window the program runs to completion in detail and gives no sample
+	{
+		run();
+		return;
+	}
+	while (!eop)
+	{
+		if (fast_forward(functional) < functional) // only the tail of the program is left
 		{
-			dest = "-";
+			run();
+			break;
 		}
-		if (rob[i].value != UNDEFINED)
+		run_instructions(warmup);
+		unsigned long long start_cycles = clock_cycles;
+		unsigned long long start_count = instruction_count;
+		run_instructions(measure);
+		if (eop || instruction_count == start_count) // the window is cut short by the end of the program (or made no progress) and is not a sample
 		{
-			good_value = true;
+			run();
+			break;
 		}
-		else
+		double cpi = (double)(clock_cycles - start_cycles) / (double)(instruction_count - start_count);
+		sample_count++;
+		sample_cpi_sum += cpi;
+		sample_cpi_square_sum += cpi * cpi;
+	}
+}
+
+void sim_ooo::run_parallel(unsigned long long interval, unsigned long long warmup, unsigned threads)
+{
+	stop_functional_front();
+	if (eop || interval == 0)
+	{
+		run();
+		return;
+	}
+	if (threads == 0)
+	{
+		threads = thread::hardware_concurrency() != 0 ? thread::hardware_concurrency() : 1;
+	}
+	// counters made up of the increases measured in every slice
+	unsigned long long sim_ooo::*counters[] = {&sim_ooo::clock_cycles, &sim_ooo::instruction_count,
+		&sim_ooo::commit_width_limited, &sim_ooo::commit_head_blocked, &sim_ooo::branches, &sim_ooo::mispredictions,
+		&sim_ooo::btb_misses, &sim_ooo::checkpoint_stalls, &sim_ooo::forwarded_loads, &sim_ooo::memory_conflicts};
+	const unsigned num_counters = sizeof(counters) / sizeof(counters[0]);
+	unsigned long long start[num_counters];
+	for (unsigned c = 0; c < num_counters; c++)
+	{
+		start[c] = this->*counters[c];
+	}
+
+	// untimed pass: the state is saved "warmup" instructions ahead of every interval boundary. The first slice
+	// starts from the current state, instructions in flight included
+	vector<string> snapshots;
+	vector<unsigned long long> warmups; // detailed instructions run before a slice is measured
+	ostringstream first;
+	save_checkpoint(first);
+	snapshots.push_back(first.str());
+	warmups.push_back(0);
+	unsigned long long position = 0;
+	for (unsigned long long boundary = interval; ; boundary += interval)
+	{
+		unsigned long long start = boundary > warmup ? boundary - warmup : 0;
+		position += fast_forward(start - position);
+		if (position < start) // the program ends before the slice starts
 		{
-			good_value = false;
+			break;
 		}
-		if ((rob[i].instruction >> 26) == EOP)
+		ostringstream snapshot;
+		save_checkpoint(snapshot);
+		snapshots.push_back(snapshot.str());
+		warmups.push_back(boundary - start);
+	}
+
+	// every slice is simulated in detail from its snapshot; the last one runs to the end of the program on this
+	// simulator, which is left in the final state
+	size_t slices = snapshots.size();
+	unsigned long long *slice_counters = new unsigned long long[slices * num_counters];
+	istringstream last(snapshots[slices - 1]);
+	restore_checkpoint(last);
+	unsigned config[8] = {data_memory_size, size_of_rob, size_of_int_rs, size_of_add_rs, size_of_mult_rs, size_of_load_rs, issue_max, commit_max};
+	atomic<size_t> next(0);
+	auto run_slices = [&]()
+	{
+		for (size_t i = next++; i < slices - 1; i = next++)
 		{
-			cout << setfill(' ') << setw(5) << to_string(i + 1) << setw(6) << "no" << setw(7) << "no" << setw(12) << "-" << setw(8) << setfill(' ') << setw(10) << "-" << setw(6) << "-" << setw(12) << "-" << setw(8) << endl;
+			sim_ooo slice(config[0], config[1], config[2], config[3], config[4], config[5], config[6], config[7]);
+			istringstream in(snapshots[i]);
+			slice.restore_checkpoint(in);
+			unsigned long long end = slice.instruction_count + warmups[i] + interval;
+			slice.run_instructions(warmups[i]);
+			unsigned long long *measured = slice_counters + i * num_counters;
+			for (unsigned c = 0; c < num_counters; c++)
+			{
+				measured[c] = slice.*counters[c];
+			}
+			// with a commit width above 1 the warmup may end a few instructions past the boundary; the slice
+			// is measured up to the cycle that reaches the next one, where the next slice starts measuring
+			if (slice.instruction_count < end)
+			{
+				slice.run_instructions(end - slice.instruction_count);
+			}
+			for (unsigned c = 0; c < num_counters; c++)
+			{
+				measured[c] = slice.*counters[c] - measured[c];
+			}
 		}
-		else
+	};
+	vector<thread> workers;
+	for (unsigned t = 1; t < threads && t < slices; t++)
+	{
+		workers.push_back(thread(run_slices));
+	}
+	run_instructions(warmups[slices - 1]);
+	unsigned long long *measured = slice_counters + (slices - 1) * num_counters;
+	for (unsigned c = 0; c < num_counters; c++)
+	{
+		measured[c] = this->*counters[c];
+	}
+	run();
+	for (unsigned c = 0; c < num_counters; c++)
+	{
+		measured[c] = this->*counters[c] - measured[c];
+	}
+	run_slices(); // then helps with the slices left
+	for (unsigned t = 0; t < workers.size(); t++)
+	{
+		workers[t].join();
+	}
+
+	for (unsigned c = 0; c < num_counters; c++)
+	{
+		this->*counters[c] = start[c];
+		for (size_t i = 0; i < slices; i++)
 		{
-			cout << setfill(' ') << setw(5) << to_string(i + 1) << setw(6) << busy << setw(7) << ready;
-			if (good_pc)
+			this->*counters[c] += slice_counters[i * num_counters + c];
+		}
+	}
+	delete[] slice_counters;
+}
+
+void sim_ooo::set_loop_extrapolation(bool enabled)
+{
+	loop_extrapolation = enabled;
+	loop_edge = false;
+	loop_body_length = loop_last_length = UNDEFINED; // detection starts at the next loop edge
+}
+
+void sim_ooo::track_loop(unsigned entry)
+{
+	unsigned word = rob[entry].pc / 4;
+	if (loop_body_length < LOOP_MAX_BODY)
+	{
+		loop_body[loop_body_length++] = word;
+	}
+	else
+	{
+		loop_body_length = UNDEFINED;
+	}
+	unsigned opcode = rob[entry].opcode;
+	bool taken = opcode == JUMP || ((opcode == BEQZ || opcode == BNEZ || opcode == BLTZ || opcode == BGTZ
+		|| opcode == BLEZ || opcode == BGEZ) && rob[entry].value != (int)rob[entry].pc + 4);
+	if (taken && (unsigned)(rob[entry].value - 4) / 4 <= word)
+	{
+		loop_edge = true;
+	}
+}
+
+/* FNV-1a over 64-bit words */
+inline void fingerprint_mix(unsigned long long &hash, unsigned long long value){
+        hash = (hash ^ value) * 0x100000001b3ULL;
+}
+
+unsigned long long sim_ooo::pipeline_fingerprint()
+{
+	unsigned long long hash = 0xcbf29ce484222325ULL;
+	unsigned cycle = (unsigned)clock_cycles;
+	fingerprint_mix(hash, pc);
+	fingerprint_mix(hash, stalled);
+	if (predictor != NULL)
+	{
+		fingerprint_mix(hash, predictor->history);
+		fingerprint_mix(hash, predictor->retired_history);
+	}
+	fingerprint_mix(hash, rob_count);
+	fingerprint_mix(hash, checkpoints_in_use);
+	for (unsigned i = 0; i < rob_count; i++)
+	{
+		const read_order_buffer &entry = rob[(rob_head + i) % size_of_rob];
+		fingerprint_mix(hash, entry.pc);
+		fingerprint_mix(hash, entry.state);
+		fingerprint_mix(hash, entry.ready);
+		fingerprint_mix(hash, entry.predicted_taken | (entry.btb_miss << 1) | (entry.mispredicted << 2) | (entry.delayed << 3));
+		bool producing = entry.data_entry != UNDEFINED && rob[entry.data_entry].busy && rob[entry.data_entry].seq < entry.seq;
+		fingerprint_mix(hash, producing ? (entry.data_entry + size_of_rob - rob_head) % size_of_rob : UNDEFINED);
+	}
+	fingerprint_mix(hash, retired_count);
+	for (unsigned i = 0; i < retired_count; i++)
+	{
+		fingerprint_mix(hash, (retired_entries[i] + size_of_rob - rob_head) % size_of_rob);
+	}
+
+	// stations and units by position, since the lowest free or ready one is always picked
+	unsigned total_rs = size_of_int_rs + size_of_add_rs + size_of_mult_rs + size_of_load_rs;
+	for (unsigned i = 0; i < total_rs; i++)
+	{
+		const reservation_station &rs = all_rs[i];
+		fingerprint_mix(hash, rs.busy | (rs.wb << 1) | (rs.cleared << 2));
+		if (rs.busy)
+		{
+			fingerprint_mix(hash, rs.pc);
+			fingerprint_mix(hash, (rs.dest + size_of_rob - rob_head) % size_of_rob);
+			fingerprint_mix(hash, rs.qj == UNDEFINED ? UNDEFINED : (rs.qj + size_of_rob - rob_head) % size_of_rob);
+			fingerprint_mix(hash, rs.qk == UNDEFINED ? UNDEFINED : (rs.qk + size_of_rob - rob_head) % size_of_rob);
+		}
+	}
+	ex_unit *units[NUM_EXE_UNITS] = {int_ex, add_ex, mult_ex, div_ex, mem_ex};
+	unsigned sizes[NUM_EXE_UNITS] = {size_of_int_ex, size_of_add_ex, size_of_mult_ex, size_of_div_ex, size_of_mem_ex};
+	for (unsigned u = 0; u < NUM_EXE_UNITS; u++)
+	{
+		for (unsigned i = 0; i < sizes[u]; i++)
+		{
+			const ex_unit &ex = units[u][i];
+			fingerprint_mix(hash, ex.busy);
+			if (ex.busy)
 			{
-				cout << setw(4) << hex << "0x" << setw(8) << setfill('0') << rob[i].pc;
+				fingerprint_mix(hash, ex.pc);
+				fingerprint_mix(hash, (ex.entry + size_of_rob - rob_head) % size_of_rob);
+				fingerprint_mix(hash, ex.finish - cycle);
 			}
-			else
+		}
+	}
+	for (ex_unit *ex = releasing; ex != NULL; ex = ex->next)
+	{
+		fingerprint_mix(hash, ex_unit_id(ex));
+	}
+	return hash;
+}
+
+void sim_ooo::end_loop_iteration(bool extrapolate)
+{
+	loop_edge = false;
+	unsigned long long fingerprint = pipeline_fingerprint();
+	unsigned long long cycles = clock_cycles - loop_edge_cycles;
+	unsigned long long stall_count = stalls - loop_edge_stalls;
+	unsigned long long limited = commit_width_limited - loop_edge_limited;
+	unsigned long long blocked = commit_head_blocked - loop_edge_blocked;
+	unsigned long long branch_count = branches - loop_edge_branches;
+	unsigned long long mispredicted = mispredictions - loop_edge_mispredictions;
+	unsigned long long btb_missed = btb_misses - loop_edge_btb_misses;
+	unsigned long long checkpoint_waits = checkpoint_stalls - loop_edge_checkpoint_stalls;
+	unsigned long long forwarded = forwarded_loads - loop_edge_forwarded;
+	unsigned long long conflicts = memory_conflicts - loop_edge_conflicts;
+	unsigned long long updates = predictor != NULL ? predictor->updates : 0;
+	bool steady = loop_body_length != UNDEFINED && loop_body_length == loop_last_length
+		&& fingerprint == loop_fingerprint && cycles == loop_delta_cycles && stall_count == loop_delta_stalls
+		&& limited == loop_delta_limited && blocked == loop_delta_blocked
+		&& branch_count == loop_delta_branches && mispredicted == loop_delta_mispredictions
+		&& btb_missed == loop_delta_btb_misses && updates == loop_edge_updates // the predictor learnt nothing new
+		&& checkpoint_waits == loop_delta_checkpoint_stalls
+		&& forwarded == loop_delta_forwarded && conflicts == loop_delta_conflicts
+		&& memcmp(loop_body, loop_last_body, loop_body_length * sizeof(unsigned)) == 0;
+
+	// the iteration that just ended is the one the next is compared with
+	unsigned *body = loop_last_body;
+	loop_last_body = loop_body;
+	loop_body = body;
+	loop_last_length = loop_body_length;
+	loop_body_length = 0;
+	loop_fingerprint = fingerprint;
+	loop_delta_cycles = cycles;
+	loop_delta_stalls = stall_count;
+	loop_delta_limited = limited;
+	loop_delta_blocked = blocked;
+	loop_delta_branches = branch_count;
+	loop_delta_mispredictions = mispredicted;
+	loop_delta_btb_misses = btb_missed;
+	loop_delta_checkpoint_stalls = checkpoint_waits;
+	loop_delta_forwarded = forwarded;
+	loop_delta_conflicts = conflicts;
+	if (steady && extrapolate && front == NULL)
+	{
+		extrapolate_loop();
+	}
+	loop_edge_cycles = clock_cycles;
+	loop_edge_stalls = stalls;
+	loop_edge_limited = commit_width_limited;
+	loop_edge_blocked = commit_head_blocked;
+	loop_edge_branches = branches;
+	loop_edge_mispredictions = mispredictions;
+	loop_edge_btb_misses = btb_misses;
+	loop_edge_checkpoint_stalls = checkpoint_stalls;
+	loop_edge_forwarded = forwarded_loads;
+	loop_edge_conflicts = memory_conflicts;
+	loop_edge_updates = updates;
+}
+
+/* executes "inst" like execute_functional, saving the word a store overwrites in the undo log first */
+static bool execute_undoable(const decoded_instruction &inst, unsigned pc, int *r, float *f, unsigned char *memory,
+	unsigned memory_size, dynamic_instruction &record, unsigned *undo_address, unsigned *undo_word, unsigned &undo_count)
+{
+	if (inst.opcode == SW || inst.opcode == SWS)
+	{
+		unsigned address = r[inst.src1] + inst.imm;
+		if (address <= memory_size && memory_size - address >= 4)
+		{
+			undo_address[undo_count] = address;
+			undo_word[undo_count++] = char2unsigned(memory + address);
+		}
+	}
+	return execute_functional(inst, pc, r, f, memory, memory_size, record);
+}
+
+static void undo_stores(unsigned char *memory, const unsigned *undo_address, const unsigned *undo_word, unsigned undo_count)
+{
+	while (undo_count > 0)
+	{
+		undo_count--;
+		unsigned2char(undo_word[undo_count], memory + undo_address[undo_count]);
+	}
+}
+
+void sim_ooo::extrapolate_loop()
+{
+	unsigned start = rob_count != 0 ? rob[rob_head].pc / 4 : pc; // oldest instruction not committed
+	if (loop_last_length == 0 || start != loop_last_body[0])
+	{
+		return;
+	}
+	int r[NUM_GP_REGISTERS], saved_r[NUM_GP_REGISTERS];
+	float f[NUM_GP_REGISTERS], saved_f[NUM_GP_REGISTERS];
+	for (unsigned i = 0; i < NUM_GP_REGISTERS; i++)
+	{
+		r[i] = int_reg[i].value;
+		f[i] = fp_reg[i].value;
+	}
+	unsigned undo_size = loop_last_length > size_of_rob ? loop_last_length : size_of_rob;
+	unsigned *undo_address = new unsigned[undo_size];
+	unsigned *undo_word = new unsigned[undo_size];
+	unsigned undo_count;
+
+	// whole iterations on the same path; the first one to leave it is undone and left to the detailed model
+	unsigned long long iterations = 0;
+	dynamic_instruction record;
+	while (true)
+	{
+		memcpy(saved_r, r, sizeof(r));
+		memcpy(saved_f, f, sizeof(f));
+		undo_count = 0;
+		bool same_path = true;
+		for (unsigned i = 0; i < loop_last_length && same_path; i++)
+		{
+			unsigned word = loop_last_body[i];
+			if (!execute_undoable(decoded_memory[word], word, r, f, data_memory, data_memory_size, record,
+				undo_address, undo_word, undo_count))
 			{
-				cout << setw(12) << "-" << setw(8);
+				same_path = false;
+				break;
 			}
-			cout << setfill(' ') << setw(10) << state << setw(6);
-			unsigned opcode = (rob[i].instruction >> 26) & 31;
-			if (opcode == BEQZ || opcode == BNEZ || opcode == BLTZ
-				|| opcode == BGTZ || opcode == BLEZ || opcode == BGEZ
-				|| opcode == JUMP)
+			unsigned next = record.next_pc;
+			while (next < decoded_memory_end && decoded_memory[next].station == 0)
 			{
-				cout << "-";
+				next++;
 			}
-			else
+			same_path = next == loop_last_body[(i + 1) % loop_last_length];
+		}
+		if (!same_path)
+		{
+			undo_stores(data_memory, undo_address, undo_word, undo_count);
+			memcpy(r, saved_r, sizeof(r));
+			memcpy(f, saved_f, sizeof(f));
+			break;
+		}
+		iterations++;
+	}
+	if (iterations == 0)
+	{
+		delete[] undo_address;
+		delete[] undo_word;
+		return;
+	}
+	for (unsigned i = 0; i < NUM_GP_REGISTERS; i++)
+	{
+		int_reg[i].value = r[i];
+		fp_reg[i].value = f[i];
+	}
+
+	// instructions in flight belong to the next iteration: their results are recomputed from the new state
+	// on a scratch copy, up to the first one off the program path
+	undo_count = 0;
+	unsigned word = start;
+	for (unsigned i = 0; i < rob_count; i++)
+	{
+		unsigned entry = (rob_head + i) % size_of_rob;
+		if (rob[entry].pc / 4 != word || !execute_undoable(decoded_memory[word], word, r, f, data_memory,
+			data_memory_size, record, undo_address, undo_word, undo_count))
+		{
+			break;
+		}
+		if (rob[entry].ready)
+		{
+			rob[entry].value = record.value;
+			unsigned opcode = rob[entry].opcode;
+			if (opcode == LWS || opcode == ADDS || opcode == SUBS || opcode == MULTS || opcode == DIVS)
 			{
-				cout << dest;
+				rob[entry].value_f = record.value_f;
 			}
-			if (rob[i].ready && (opcode == BEQZ || opcode == BNEZ || opcode == BLTZ
-				|| opcode == BGTZ || opcode == BLEZ || opcode == BGEZ
-				|| opcode == JUMP))
+		}
+		else
+		{
+			if (rob_trace == NULL)
 			{
-				cout << setw(4) << hex << "0x" << setw(8) << setfill('0') << (rob[i].value);
+				rob_trace = new dynamic_instruction[size_of_rob];
 			}
-			else
+			rob_trace[entry] = record;
+			rob[entry].traced = true;
+		}
+		word = record.next_pc;
+		while (word < decoded_memory_end && decoded_memory[word].station == 0)
+		{
+			word++;
+		}
+	}
+	undo_stores(data_memory, undo_address, undo_word, undo_count);
+	delete[] undo_address;
+	delete[] undo_word;
+
+	// everything in flight moves forward in time with the clock
+	unsigned long long shift = iterations * loop_delta_cycles;
+	for (unsigned i = 0; i < rob_count; i++)
+	{
+		unsigned entry = (rob_head + i) % size_of_rob;
+		unsigned long long *stages[8] = {&iq[entry].Issue, &iq[entry].Exe, &iq[entry].WR, &iq[entry].Commit, NULL, NULL, NULL, NULL};
+		if (rob[entry].log_index < instruction_log_length)
+		{
+			instruction_q &log = il[rob[entry].log_index];
+			stages[4] = &log.Issue;
+			stages[5] = &log.Exe;
+			stages[6] = &log.WR;
+			stages[7] = &log.Commit;
+		}
+		for (unsigned s = 0; s < 8; s++)
+		{
+			if (stages[s] != NULL && *stages[s] != UNDEFINED_CYCLE)
 			{
-				if (good_value)
-				{
-					cout << setw(4) << hex << "0x" << setw(8) << setfill('0') << rob[i].value;
-				}
-				else
-				{
-					cout << setw(12) << "-" << setw(8);
-				}
+				*stages[s] += shift;
 			}
-			cout << endl;
 		}
 	}
-	cout << endl;
+	ex_unit *units[NUM_EXE_UNITS] = {int_ex, add_ex, mult_ex, div_ex, mem_ex};
+	unsigned sizes[NUM_EXE_UNITS] = {size_of_int_ex, size_of_add_ex, size_of_mult_ex, size_of_div_ex, size_of_mem_ex};
+	for (unsigned u = 0; u < NUM_EXE_UNITS; u++)
+	{
+		for (unsigned i = 0; i < sizes[u]; i++)
+		{
+			if (units[u][i].busy)
+			{
+				units[u][i].finish += (unsigned)shift;
+			}
+		}
+	}
+	if (wheel_size != 0)
+	{
+		ex_unit **rotated = new ex_unit*[wheel_size];
+		for (unsigned slot = 0; slot < wheel_size; slot++)
+		{
+			rotated[(slot + shift) & (wheel_size - 1)] = wheel[slot];
+		}
+		delete[] wheel;
+		wheel = rotated;
+	}
+
+	clock_cycles += shift;
+	instruction_count += iterations * loop_last_length;
+	stalls += iterations * loop_delta_stalls;
+	commit_width_limited += iterations * loop_delta_limited;
+	commit_head_blocked += iterations * loop_delta_blocked;
+	branches += iterations * loop_delta_branches;
+	mispredictions += iterations * loop_delta_mispredictions;
+	btb_misses += iterations * loop_delta_btb_misses;
+	checkpoint_stalls += iterations * loop_delta_checkpoint_stalls;
+	forwarded_loads += iterations * loop_delta_forwarded;
+	memory_conflicts += iterations * loop_delta_conflicts;
+	extrapolations++;
+	extrapolated_iterations += iterations;
+	extrapolated_instructions += iterations * loop_last_length;
+	extrapolated_cycles += shift;
 }
 
-void sim_ooo::print_reservation_stations(){
-	cout << "RESERVATION STATIONS" << endl;
-	cout  << setfill(' ');
-	cout << setw(7) << "Name" << setw(6) << "Busy" << setw(12) << "PC" << setw(12) << "Vj" << setw(12) << "Vk" << setw(6) << "Qj" << setw(6) << "Qk" << setw(6) << "Dest" << setw(12) << "Address" << endl; 
-	
-	// fill here
-	// print out int_rs
-	for (unsigned i = 0; i < size_of_int_rs; i++)
+unsigned long long sim_ooo::skip_idle_cycles(unsigned long long max_cycles)
+{
+	// the first thing commit does every cycle, so the checks below see the same state it would
+	clear_write_back_check();
+	clear_commit_stall();
+
+	// commit: the oldest instruction is not ready to retire
+	if (rob_count != 0 && rob[rob_head].ready)
 	{
-		unsigned opcode = int_rs[i].opcode;
-		if (opcode == EOP)
+		return 0;
+	}
+
+	// write result: no unit is being freed or writing its result this cycle
+	unsigned cycle = (unsigned)clock_cycles;
+	if (releasing != NULL || wheel_size == 0 || wheel[cycle & (wheel_size - 1)] != NULL)
+	{
+		return 0;
+	}
+
+	// execute: no waiting instruction can be dispatched to a free unit
+	if ((unit_free(int_ex, size_of_int_ex) && first_ready(INTEGER) != -1)
+		|| (unit_free(add_ex, size_of_add_ex) && first_ready(ADDER) != -1)
+		|| (unit_free(mem_ex, size_of_mem_ex) && first_ready_memory() != -1)
+		|| (unit_free(mult_ex, size_of_mult_ex) && first_ready(MULTIPLIER) != -1)
+		|| (unit_free(div_ex, size_of_div_ex) && first_ready(DIVIDER) != -1))
+	{
+		return 0;
+	}
+
+	// issue: the rob or the reservation stations needed by the next instruction are full, or it is a branch
+	// and no rename checkpoint is free
+	bool fetch_past_end = false, checkpoint_wait = false;
+	if (rob_count != size_of_rob && pc >= decoded_memory_end && pc < decoded_memory_size)
+	{
+		fetch_past_end = true; // only empty words are left, issue just moves the pc towards the end
+	}
+	else if (rob_count != size_of_rob && pc < decoded_memory_size)
+	{
+		bool open;
+		switch (decoded_memory[pc].station)
 		{
-			cout << setw(7) << int_rs[i].name << setw(6) << "no" << setw(12) << "-" << setw(12) << "-" << setw(12) << "-" << setw(6) << "-" << setw(6) << "-" << setw(6) << "-" << setw(12) << "-" << setw(8) << endl;
+		case INTEGER_RS:
+			open = get_open_rs(int_rs) != -1;
+			break;
+		case ADD_RS:
+			open = get_open_rs(add_rs) != -1;
+			break;
+		case MULT_RS:
+			open = get_open_rs(mult_rs) != -1;
+			break;
+		case LOAD_B:
+			open = get_open_rs(load_rs) != -1;
+			break;
+		default: // empty word, issue still moves the pc forward
+			return 0;
 		}
-		else
+		if (open)
 		{
-			for (unsigned j = 0; j < 9; j++)
+			if (decoded_memory[pc].target == UNDEFINED || checkpoints_in_use != rename_checkpoints)
 			{
-				switch (j)
-				{
-				case 0:
-					cout << setw(7) << int_rs[i].name << setw(6);
-					break;
-				case 1:
-					if (int_rs[i].busy)
-					{
-						cout << "yes";
-					}
-					else
-					{
-						cout << "no";
-					}
-					break;
-				case 2:
-					if (int_rs[i].pc < 10000000)
-					{
-						cout << setw(4) << hex << "0x" << setw(8) << setfill('0') << int_rs[i].pc << setfill(' ');
-					}
-					else
-					{
-						cout << setw(12) << "-" << setw(8);
-					}
-					break;
-				case 3:
-					if (int_rs[i].vj < 65536 && int_rs[i].vj > -65536 && int_rs[i].vj != UNDEFINED)
-					{
-						cout << setw(4) << hex << "0x" << setw(8) << setfill('0') << int_rs[i].vj << setfill(' ');
-					}
-					else
-					{
-						cout << setw(12) << "-" << setw(8);
-					}
-					break;
-				case 4:
-					if (int_rs[i].vk < 65536 && int_rs[i].vk > -65536 && int_rs[i].vk != UNDEFINED && opcode != ADDI && opcode != SUBI)
-					{
-						cout << setw(4) << hex << "0x" << setw(8) << setfill('0') << int_rs[i].vk << setfill(' ');
-					}
-					else
-					{
-						cout << setw(12) << "-" << setw(8);
-					}
-					break;
-				case 5:
-					if (int_rs[i].qj < 32)
-					{
-						cout << setw(6) << to_string(int_rs[i].qj);
-					}
-					else
-					{
-						cout << setw(6) << "-";
-					}
-					break;
-				case 6:
-					if (int_rs[i].qk < 32)
-					{
-						cout << setw(6) << to_string(int_rs[i].qk);
-					}
-					else
-					{
-						cout << setw(6) << "-";
-					}
-					break;
-				case 7:
-					if (int_rs[i].dest < size_of_rob)
-					{
-						cout << setw(6) << to_string(int_rs[i].dest);
-					}
-					else
-					{
-						cout << setw(6) << "-";
-					}
-					break;
-				case 8:
-					cout << setw(12) << "-" << setw(8) << endl;
-					break;
-				}
+				return 0;
 			}
+			checkpoint_wait = true;
 		}
 	}
-	// print out Load_rs
-	for (unsigned i = 0; i < size_of_load_rs; i++)
+
+	// nothing happens until the first unit in the timing wheel writes its result
+	unsigned skip = 1;
+	while (skip < wheel_size && wheel[(cycle + skip) & (wheel_size - 1)] == NULL)
 	{
-		for (unsigned j = 0; j < 9; j++)
+		skip++;
+	}
+	if (skip == wheel_size) // nothing is in flight, so waiting would never end
+	{
+		return 0;
+	}
+	if (skip > max_cycles)
+	{
+		skip = (unsigned)max_cycles;
+	}
+	if (fetch_past_end)
+	{
+		unsigned long long next_pc = pc + (unsigned long long)skip * issue_max;
+		pc = next_pc < decoded_memory_size ? (unsigned)next_pc : decoded_memory_size;
+	}
+	if (rob_count != 0) // commit is held by the rob head in every skipped cycle
+	{
+		commit_head_blocked += skip;
+	}
+	if (checkpoint_wait) // and issue by the branch without a checkpoint
+	{
+		checkpoint_stalls += skip;
+	}
+	clock_cycles += skip;
+	return skip;
+}
+
+bool sim_ooo::unit_free(ex_unit *ex, unsigned size)
+{
+	for (unsigned i = 0; i < size; i++)
+	{
+		if (!ex[i].busy)
 		{
-			switch (j)
+			return true;
+		}
+	}
+	return false;
+}
+
+//reset the state of the sim_oooulator
+void sim_ooo::reset()
+{
+	//Add reset for reservation stations
+	for (int i = 0; i < NUM_GP_REGISTERS; i++)
+	{
+		int_reg[i].value = UNDEFINED;
+		int_reg[i].entry = UNDEFINED;
+		fp_reg[i].value = (float)(UNDEFINED);
+		fp_reg[i].entry = UNDEFINED;
+	}
+	clock_cycles = 0;
+	instruction_count = 0;
+	stalls = 0;
+}
+
+int sim_ooo::get_int_register(unsigned reg)
+{
+	unsigned rob_entry = get_pending_int_register(reg);
+	if (rob_entry != UNDEFINED)
+	{
+		if (rob[rob_entry].ready)
+		{
+			return rob[rob_entry].value;
+		}
+		else
+		{
+			return UNDEFINED;
+		}
+	}
+	return int_reg[reg].value;
+}
+
+void sim_ooo::set_int_register(unsigned reg, int value)
+{
+	int_reg[reg].value = value;
+}
+
+float sim_ooo::get_fp_register(unsigned reg)
+{
+	unsigned rob_entry = get_pending_fp_register(reg);
+	if (rob_entry != UNDEFINED)
+	{
+		if (rob[rob_entry].ready)
+		{
+			return rob[rob_entry].value_f;
+		}
+		else
+		{
+			return unsigned2float(UNDEFINED);
+		}
+	}
+	
+	return fp_reg[reg].value;
+}
+
+void sim_ooo::set_fp_register(unsigned reg, float value)
+{
+	fp_reg[reg].value = value;
+}
+
+unsigned sim_ooo::get_pending_int_register(unsigned reg)
+{
+	unsigned index = UNDEFINED;
+	for (unsigned i = 0, entry = rob_head; i < rob_count; i++, entry = (entry + 1) % size_of_rob) // oldest to youngest
+	{
+		if (rob[entry].destination == pack_register(reg, true) && rob[entry].opcode != SW)
+		{
+			index = entry;
+		}
+	}
+	return index;
+}
+
+unsigned sim_ooo::get_pending_fp_register(unsigned reg)
+{
+	unsigned index = UNDEFINED;
+	for (unsigned i = 0, entry = rob_head; i < rob_count; i++, entry = (entry + 1) % size_of_rob) // oldest to youngest
+	{
+		if (rob[entry].destination == pack_register(reg, false) && rob[entry].opcode != SWS)
+		{
+			index = entry;
+		}
+	}
+	return index;
+}
+
+void sim_ooo::print_status(){
+	print_pending_instructions();
+	print_rob();
+	print_reservation_stations();
+	print_registers();
+}
+
+void sim_ooo::print_memory(unsigned start_address, unsigned end_address){
+	cout << "DATA MEMORY[0x" << hex << setw(8) << setfill('0') << start_address << ":0x" << hex << setw(8) << setfill('0') <<  end_address << "]" << endl;
+	for (unsigned i=start_address; i<end_address; i++){
+		if (i%4 == 0) cout << "0x" << hex << setw(8) << setfill('0') << i << ": "; 
+		cout << hex << setw(2) << setfill('0') << int(data_memory[i]) << " ";
+		if (i%4 == 3){
+			cout << endl;
+		}
+	} 
+}
+
+void sim_ooo::write_memory(unsigned address, unsigned value)
+{
+	unsigned2char(value,data_memory+address);
+	if (store_logging)
+	{
+		if (store_log_length == store_log_capacity) // log is full so double its capacity
+		{
+			unsigned new_capacity = store_log_capacity == 0 ? 64 : store_log_capacity * 2;
+			unsigned *new_log = new unsigned[2 * new_capacity];
+			if (store_log != NULL)
 			{
-			case 0:
-				cout << setw(7) << load_rs[i].name << setw(6);
-				break;
-			case 1:
-				if (load_rs[i].busy)
-				{
-					cout << "yes";
-				}
-				else
-				{
-					cout << "no";
-				}
-				break;
-			case 2:
-				if (load_rs[i].pc < 10000000)
-				{
-					cout << setw(4) << hex << "0x" << setw(8) << setfill('0') << load_rs[i].pc << setfill(' ');
-				}
-				else
-				{
-					cout << setw(12) << "-" << setw(8);
-				}
-				break;
-			case 3:
-				if (load_rs[i].vj < 100000 && load_rs[i].vj > -100000 && load_rs[i].vj != UNDEFINED)
-				{
-					cout << setw(4) << hex << "0x" << setw(8) << setfill('0') << load_rs[i].vj << setfill(' ');
-				}
-				else
-				{
-					cout << setw(12) << "-" << setw(8);
-				}
-				break;
-			case 4:
-				cout << setw(12) << "-" << setw(8);
-				break;
-			case 5:
-				if (load_rs[i].qj < 32)
-				{
-					cout << setw(6) << to_string(load_rs[i].qj);
-				}
-				else
-				{
-					cout << setw(6) << "-";
-				}
-				break;
-			case 6:
-				if (load_rs[i].qk < 32)
-				{
-					cout << setw(6) << to_string(load_rs[i].qk);
-				}
-				else
-				{
-					cout << setw(6) << "-";
-				}
-				break;
-			case 7:
-				if (load_rs[i].dest < size_of_rob)
+				memcpy(new_log, store_log, 2 * store_log_length * sizeof(unsigned));
+			}
+			delete[] store_log;
+			store_log = new_log;
+			store_log_capacity = new_capacity;
+		}
+		store_log[2 * store_log_length] = address;
+		store_log[2 * store_log_length + 1] = value;
+		store_log_length++;
+	}
+}
+
+void sim_ooo::set_store_log(bool enabled)
+{
+	store_logging = enabled;
+	store_log_length = 0;
+}
+
+unsigned sim_ooo::get_store_log_length()
+{
+	return store_log_length;
+}
+
+void sim_ooo::get_logged_store(unsigned index, unsigned &address, unsigned &value)
+{
+	address = store_log[2 * index];
+	value = store_log[2 * index + 1];
+}
+
+void sim_ooo::clear_store_log()
+{
+	store_log_length = 0;
+}
+
+void sim_ooo::apply_store(unsigned address, unsigned value)
+{
+	unsigned2char(value, data_memory + address);
+}
+
+void sim_ooo::print_registers(){
+        unsigned i;
+	cout << "GENERAL PURPOSE REGISTERS" << endl;
+	cout << setfill(' ') << setw(8) << "Register" << setw(22) << "Value" << setw(5) << "ROB" << endl;
+        for (i=0; i< NUM_GP_REGISTERS; i++){
+                if (get_pending_int_register(i)!=UNDEFINED) 
+			cout << setfill(' ') << setw(7) << "R" << dec << i << setw(22) << "-" << setw(5) << int_reg[i].entry << endl;
+                else if (get_int_register(i)!=(int)UNDEFINED) 
+			cout << setfill(' ') << setw(7) << "R" << dec << i << setw(11) << get_int_register(i) << hex << "/0x" << setw(8) << setfill('0') << get_int_register(i) << setfill(' ') << setw(5) << "-" << endl;
+        }
+	for (i=0; i< NUM_GP_REGISTERS; i++){
+                if (get_pending_fp_register(i)!=UNDEFINED) 
+			cout << setfill(' ') << setw(7) << "F" << dec << i << setw(22) << "-" << setw(5) << fp_reg[i].entry << endl;
+                else if (get_fp_register(i)!=UNDEFINED) 
+			cout << setfill(' ') << setw(7) << "F" << dec << i << setw(11) << get_fp_register(i) << hex << "/0x" << setw(8) << setfill('0') << float2unsigned(get_fp_register(i)) << setfill(' ') << setw(5) << "-" << endl;
+	}
+	cout << endl;
+}
+
+void sim_ooo::print_rob(){
+	cout << "REORDER BUFFER" << endl; 
+	cout << setfill(' ') << setw(5) << "Entry" << setw(6) << "Busy" << setw(7) << "Ready" << setw(12) << "PC" << setw(10) << "State" << setw(6) << "Dest" << setw(12) << "Value" << endl;
+	
+	//fill here
+	unsigned size = size_of_rob;
+	string busy, ready, state, dest;
+	bool good_pc, good_value;
+	for (unsigned i = 0; i < size; i++)
+	{		
+		if (rob[i].busy)
+		{
+			busy = "yes";
+		}
+		else
+		{
+			busy = "no";
+		}
+		if (rob[i].ready)
+		{
+			ready = "yes";
+		}
+		else
+		{
+			ready = "no";
+		}
+		if (rob[i].pc != UNDEFINED)
+		{
+			good_pc = true;
+		}
+		else
+		{
+			good_pc = false;
+		}
+		if (rob[i].state != NO_STAGE)
+		{
+			state = stage_names[rob[i].state - 1];
+		}
+		else
+		{
+			state = "-";
+		}
+		if (rob[i].destination != UNDEFINED)
+		{
+			dest = ((rob[i].destination & FP_REGISTER) ? "F" : "R") + to_string(register_index(rob[i].destination));
+		}
+		else
+		{
+			dest = "-";
+		}
+		if (rob[i].value != UNDEFINED)
+		{
+			good_value = true;
+		}
+		else
+		{
+			good_value = false;
+		}
+		if (rob[i].opcode == EOP)
+		{
+			cout << setfill(' ') << setw(5) << to_string(i + 1) << setw(6) << "no" << setw(7) << "no" << setw(12) << "-" << setw(8) << setfill(' ') << setw(10) << "-" << setw(6) << "-" << setw(12) << "-" << setw(8) << endl;
+		}
+		else
+		{
+			cout << setfill(' ') << setw(5) << to_string(i + 1) << setw(6) << busy << setw(7) << ready;
+			if (good_pc)
+			{
+				cout << setw(4) << hex << "0x" << setw(8) << setfill('0') << rob[i].pc;
+			}
+			else
+			{
+				cout << setw(12) << "-" << setw(8);
+			}
+			cout << setfill(' ') << setw(10) << state << setw(6);
+			unsigned opcode = rob[i].opcode;
+			if (opcode == BEQZ || opcode == BNEZ || opcode == BLTZ
+				|| opcode == BGTZ || opcode == BLEZ || opcode == BGEZ
+				|| opcode == JUMP)
+			{
+				cout << "-";
+			}
+			else
+			{
+				cout << dest;
+			}
+			if (rob[i].ready && (opcode == BEQZ || opcode == BNEZ || opcode == BLTZ
+				|| opcode == BGTZ || opcode == BLEZ || opcode == BGEZ
+				|| opcode == JUMP))
+			{
+				cout << setw(4) << hex << "0x" << setw(8) << setfill('0') << (rob[i].value);
+			}
+			else
+			{
+				if (good_value)
 				{
-					cout << setw(6) << to_string(load_rs[i].dest);
+					cout << setw(4) << hex << "0x" << setw(8) << setfill('0') << rob[i].value;
 				}
 				else
 				{
-					cout << setw(6) << "-";
-				}
-				break;
-			case 8:
-				if (load_rs[i].dest < size_of_rob)
-				{
-					cout << setw(4) << hex << "0x" << setw(8) << setfill('0') << load_rs[i].a << setfill(' ') << endl;
+					cout << setw(12) << "-" << setw(8);
 				}
-				else
+			}
+			cout << endl;
+		}
+	}
+	cout << endl;
+}
+
+void sim_ooo::print_reservation_stations(){
+	cout << "RESERVATION STATIONS" << endl;
+	cout  << setfill(' ');
+	cout << setw(7) << "Name" << setw(6) << "Busy" << setw(12) << "PC" << setw(12) << "Vj" << setw(12) << "Vk" << setw(6) << "Qj" << setw(6) << "Qk" << setw(6) << "Dest" << setw(12) << "Address" << endl; 
+	
+	// fill here
+	// print out int_rs
+	for (unsigned i = 0; i < size_of_int_rs; i++)
+	{
+		unsigned opcode = int_rs[i].opcode;
+		if (opcode == EOP)
+		{
+			cout << setw(7) << int_rs[i].name << setw(6) << "no" << setw(12) << "-" << setw(12) << "-" << setw(12) << "-" << setw(6) << "-" << setw(6) << "-" << setw(6) << "-" << setw(12) << "-" << setw(8) << endl;
+		}
+		else
+		{
+			for (unsigned j = 0; j < 9; j++)
+			{
+				switch (j)
 				{
+				case 0:
+					cout << setw(7) << int_rs[i].name << setw(6);
+					break;
+				case 1:
+					if (int_rs[i].busy)
+					{
+						cout << "yes";
+					}
+					else
+					{
+						cout << "no";
+					}
+					break;
+				case 2:
+					if (int_rs[i].pc < 10000000)
+					{
+						cout << setw(4) << hex << "0x" << setw(8) << setfill('0') << int_rs[i].pc << setfill(' ');
+					}
+					else
+					{
+						cout << setw(12) << "-" << setw(8);
+					}
+					break;
+				case 3:
+					if (int_rs[i].vj < 65536 && int_rs[i].vj > -65536 && int_rs[i].vj != UNDEFINED)
+					{
+						cout << setw(4) << hex << "0x" << setw(8) << setfill('0') << int_rs[i].vj << setfill(' ');
+					}
+					else
+					{
+						cout << setw(12) << "-" << setw(8);
+					}
+					break;
+				case 4:
+					if (int_rs[i].vk < 65536 && int_rs[i].vk > -65536 && int_rs[i].vk != UNDEFINED && opcode != ADDI && opcode != SUBI)
+					{
+						cout << setw(4) << hex << "0x" << setw(8) << setfill('0') << int_rs[i].vk << setfill(' ');
+					}
+					else
+					{
+						cout << setw(12) << "-" << setw(8);
+					}
+					break;
+				case 5:
+					if (int_rs[i].qj < 32)
+					{
+						cout << setw(6) << to_string(int_rs[i].qj);
+					}
+					else
+					{
+						cout << setw(6) << "-";
+					}
+					break;
+				case 6:
+					if (int_rs[i].qk < 32)
+					{
+						cout << setw(6) << to_string(int_rs[i].qk);
+					}
+					else
+					{
+						cout << setw(6) << "-";
+					}
+					break;
+				case 7:
+					if (int_rs[i].dest < size_of_rob)
+					{
+						cout << setw(6) << to_string(int_rs[i].dest);
+					}
+					else
+					{
+						cout << setw(6) << "-";
+					}
+					break;
+				case 8:
 					cout << setw(12) << "-" << setw(8) << endl;
+					break;
 				}
+			}
+		}
+	}
+	// print out Load_rs
+	for (unsigned i = 0; i < size_of_load_rs; i++)
+	{
+		for (unsigned j = 0; j < 9; j++)
+		{
+			switch (j)
+			{
+			case 0:
+				cout << setw(7) << load_rs[i].name << setw(6);
 				break;
+			case 1:
+				if (load_rs[i].busy)
+				{
+					cout << "yes";
+				}
+				else
+				{
+					cout << "no";
+				}
+				break;
+			case 2:
+				if (load_rs[i].pc < 10000000)
+				{
+					cout << setw(4) << hex << "0x" << setw(8) << setfill('0') << load_rs[i].pc << setfill(' ');
+				}
+				else
+				{
+					cout << setw(12) << "-" << setw(8);
+				}
+				break;
+			case 3:
+				if (load_rs[i].vj < 100000 && load_rs[i].vj > -100000 && load_rs[i].vj != UNDEFINED)
+				{
+					cout << setw(4) << hex << "0x" << setw(8) << setfill('0') << load_rs[i].vj << setfill(' ');
+				}
+				else
+				{
+					cout << setw(12) << "-" << setw(8);
+				}
+				break;
+			case 4:
+				cout << setw(12) << "-" << setw(8);
+				break;
+			case 5:
+				if (load_rs[i].qj < 32)
+				{
+					cout << setw(6) << to_string(load_rs[i].qj);
+				}
+				else
+				{
+					cout << setw(6) << "-";
+				}
+				break;
+			case 6:
+				if (load_rs[i].qk < 32)
+				{
+					cout << setw(6) << to_string(load_rs[i].qk);
+				}
+				else
+				{
+					cout << setw(6) << "-";
+				}
+				break;
+			case 7:
+				if (load_rs[i].dest < size_of_rob)
+				{
+					cout << setw(6) << to_string(load_rs[i].dest);
+				}
+				else
+				{
+					cout << setw(6) << "-";
+				}
+				break;
+			case 8:
+				if (load_rs[i].dest < size_of_rob)
+				{
+					cout << setw(4) << hex << "0x" << setw(8) << setfill('0') << load_rs[i].a << setfill(' ') << endl;
+				}
+				else
+				{
+					cout << setw(12) << "-" << setw(8) << endl;
+				}
+				break;
+			}
+		}
+	}
+	// print out add_rs
+	for (unsigned i = 0; i < size_of_add_rs; i++)
+	{
+		for (unsigned j = 0; j < 9; j++)
+		{
+			switch (j)
+			{
+			case 0:
+				cout << setw(7) << add_rs[i].name << setw(6);
+				break;
+			case 1:
+				if (add_rs[i].busy)
+				{
+					cout << "yes";
+				}
+				else
+				{
+					cout << "no";
+				}
+				break;
+			case 2:
+				if (add_rs[i].pc < 10000000)
+				{
+					cout << setw(4) << hex << "0x" << setw(8) << setfill('0') << add_rs[i].pc << setfill(' ');
+				}
+				else
+				{
+					cout << setw(12) << "-" << setw(8);
+				}
+				break;
+			case 3:
+				if (add_rs[i].opcode == ADDS || add_rs[i].opcode == SUBS)
+				{
+					if (add_rs[i].vjf < 100000.00 && add_rs[i].vjf > -100000.00 && add_rs[i].vjf != unsigned2float(UNDEFINED))
+					{
+						cout << setw(4) << hex << "0x" << setw(8) << setfill('0') << float2unsigned(add_rs[i].vjf) << setfill(' ');
+					}
+					else
+					{
+						cout << setw(12) << "-" << setw(8);
+					}
+				}
+				else
+				{
+					if (add_rs[i].vj < 100000 && add_rs[i].vj > -100000 && add_rs[i].vj != (UNDEFINED))
+					{
+						cout << setw(4) << hex << "0x" << setw(8) << setfill('0') << add_rs[i].vj << setfill(' ');
+					}
+					else
+					{
+						cout << setw(12) << "-" << setw(8);
+					}
+				}
+				break;
+			case 4:
+				if (add_rs[i].opcode == ADDS || add_rs[i].opcode == SUBS)
+				{
+					if (add_rs[i].vkf < 100000.00 && add_rs[i].vkf > -100000.00 && add_rs[i].vkf != unsigned2float(UNDEFINED))
+					{
+						cout << setw(4) << hex << "0x" << setw(8) << setfill('0') << float2unsigned(add_rs[i].vkf) << setfill(' ');
+					}
+					else
+					{
+						cout << setw(12) << "-" << setw(8);
+					}
+				}
+				else
+				{
+					if (add_rs[i].vk < 100000 && add_rs[i].vk > -100000 && add_rs[i].vk != (UNDEFINED))
+					{
+						cout << setw(4) << hex << "0x" << setw(8) << setfill('0') << add_rs[i].vk << setfill(' ');
+					}
+					else
+					{
+						cout << setw(12) << "-" << setw(8);
+					}
+				}
+				break;
+			case 5:
+				if (add_rs[i].qj < 32)
+				{
+					cout << setw(6) << to_string(add_rs[i].qj);
+				}
+				else
+				{
+					cout << setw(6) << "-";
+				}
+				break;
+			case 6:
+				if (add_rs[i].qk < 32)
+				{
+					cout << setw(6) << to_string(add_rs[i].qk);
+				}
+				else
+				{
+					cout << setw(6) << "-";
+				}
+				break;
+			case 7:
+				if (add_rs[i].dest < size_of_rob)
+				{
+					cout << setw(6) << to_string(add_rs[i].dest);
+				}
+				else
+				{
+					cout << setw(6) << "-";
+				}
+				break;
+			case 8:
+				cout << setw(12) << "-" << setw(8) << endl;
+				break;
+			}
+		}
+	}
+	// print out mult_rs
+	for (unsigned i = 0; i < size_of_mult_rs; i++)
+	{
+		for (unsigned j = 0; j < 9; j++)
+		{
+			switch (j)
+			{
+			case 0:
+				cout << setw(7) << mult_rs[i].name << setw(6);
+				break;
+			case 1:
+				if (mult_rs[i].busy)
+				{
+					cout << "yes";
+				}
+				else
+				{
+					cout << "no";
+				}
+				break;
+			case 2:
+				if (mult_rs[i].pc < 10000000)
+				{
+					cout << setw(4) << hex << "0x" << setw(8) << setfill('0') << mult_rs[i].pc << setfill(' ');
+				}
+				else
+				{
+					cout << setw(12) << "-" << setw(8);
+				}
+				break;
+			case 3:
+				if (mult_rs[i].opcode == MULTS || mult_rs[i].opcode == DIVS)
+				{
+					if (mult_rs[i].vjf < 100000.00 && mult_rs[i].vjf > -100000.00 && mult_rs[i].vjf != unsigned2float(UNDEFINED))
+					{
+						cout << setw(4) << hex << "0x" << setw(8) << setfill('0') << float2unsigned(mult_rs[i].vjf) << setfill(' ');
+					}
+					else
+					{
+						cout << setw(12) << "-" << setw(8);
+					}
+				}
+				else
+				{
+					if (mult_rs[i].vj < 100000 && mult_rs[i].vj > -100000 && mult_rs[i].vj != (UNDEFINED))
+					{
+						cout << setw(4) << hex << "0x" << setw(8) << setfill('0') << mult_rs[i].vj << setfill(' ');
+					}
+					else
+					{
+						cout << setw(12) << "-" << setw(8);
+					}
+				}
+				break;
+			case 4:
+				if (mult_rs[i].opcode == MULTS || mult_rs[i].opcode == DIVS)
+				{
+					if (mult_rs[i].vkf < 100000.00 && mult_rs[i].vkf > -100000.00 && mult_rs[i].vkf != unsigned2float(UNDEFINED))
+					{
+						cout << setw(4) << hex << "0x" << setw(8) << setfill('0') << float2unsigned(mult_rs[i].vkf) << setfill(' ');
+					}
+					else
+					{
+						cout << setw(12) << "-" << setw(8);
+					}
+				}
+				else
+				{
+					if (mult_rs[i].vk < 100000 && mult_rs[i].vk > -100000 && mult_rs[i].vk != (UNDEFINED))
+					{
+						cout << setw(4) << hex << "0x" << setw(8) << setfill('0') << mult_rs[i].vk << setfill(' ');
+					}
+					else
+					{
+						cout << setw(12) << "-" << setw(8);
+					}
+				}
+				break;
+			case 5:
+				if (mult_rs[i].qj < 32)
+				{
+					cout << setw(6) << to_string(mult_rs[i].qj);
+				}
+				else
+				{
+					cout << setw(6) << "-";
+				}
+				break;
+			case 6:
+				if (mult_rs[i].qk < 32)
+				{
+					cout << setw(6) << to_string(mult_rs[i].qk);
+				}
+				else
+				{
+					cout << setw(6) << "-";
+				}
+				break;
+			case 7:
+				if (mult_rs[i].dest < size_of_rob)
+				{
+					cout << setw(6) << to_string(mult_rs[i].dest);
+				}
+				else
+				{
+					cout << setw(6) << "-";
+				}
+				break;
+			case 8:
+				cout << setw(12) << "-" << setw(8) << endl;
+				break;
+			}
+		}
+	}
+	cout << endl;
+}
+
+void sim_ooo::print_pending_instructions(){
+	cout << "PENDING INSTRUCTIONS STATUS" << endl;
+	cout << setfill(' ');
+	cout << setw(10) << "PC" << setw(7) << "Issue" << setw(7) << "Exe" << setw(7) << "WR" << setw(7) << "Commit";
+	cout << endl;
+
+	for (unsigned i = 0; i < size_of_rob; i++)
+	{
+		for (unsigned j = 0; j < 5; j++)
+		{
+			switch (j)
+			{
+			case 0:
+				if (iq[i].pc != UNDEFINED)
+				{
+					cout << setw(2) << hex << "0x" << setw(8) << setfill('0') << iq[i].pc << setfill(' ');
+				}
+				else
+				{
+					cout << setw(10) << "-";
+				}
+				break;
+			case 1:
+				if (iq[i].Issue != UNDEFINED_CYCLE)
+				{
+					cout << setw(7) << to_string(iq[i].Issue);
+				}
+				else
+				{
+					cout << setw(7) << "-";
+				}
+				break;
+			case 2:
+				if (iq[i].Exe != UNDEFINED_CYCLE)
+				{
+					cout << setw(7) << to_string(iq[i].Exe);
+				}
+				else
+				{
+					cout << setw(7) << "-";
+				}
+				break;
+			case 3:
+				if (iq[i].WR != UNDEFINED_CYCLE)
+				{
+					cout << setw(7) << to_string(iq[i].WR);
+				}
+				else
+				{
+					cout << setw(7) << "-";
+				}
+				break;
+			case 4:
+				if (iq[i].Commit != UNDEFINED_CYCLE)
+				{
+					cout << setw(7) << to_string(iq[i].Commit) << endl;
+				}
+				else
+				{
+					cout << setw(7) << "-" << endl;
+				}
+				break;
+			}
+		}
+	}
+	cout << endl;
+}
+
+void sim_ooo::print_log()
+{
+	cout << "EXECUTION LOG" << endl;
+	cout << setfill(' ');
+	cout << setw(10) << "PC" << setw(7) << "Issue" << setw(7) << "Exe" << setw(7) << "WR" << setw(7) << "Commit";
+	cout << endl;
+
+	for (unsigned long long i = 0; i < instruction_log_length; i++)
+	{
+		for (unsigned j = 0; j < 5; j++)
+		{
+			if (il[i].pc < final_pc)
+			{
+				switch (j)
+				{
+				case 0:
+					if (il[i].pc != UNDEFINED)
+					{
+						cout << setw(2) << hex << "0x" << setw(8) << setfill('0') << il[i].pc << setfill(' ');
+					}
+					else
+					{
+						cout << setw(10) << "-";
+					}
+					break;
+				case 1:
+					if (il[i].Issue < clock_cycles)
+					{
+						cout << setw(7) << to_string(il[i].Issue);
+					}
+					else
+					{
+						cout << setw(7) << "-";
+					}
+					break;
+				case 2:
+					if (il[i].Exe < clock_cycles)
+					{
+						cout << setw(7) << to_string(il[i].Exe);
+					}
+					else
+					{
+						cout << setw(7) << "-";
+					}
+					break;
+				case 3:
+					if (il[i].WR < clock_cycles)
+					{
+						cout << setw(7) << to_string(il[i].WR);
+					}
+					else
+					{
+						cout << setw(7) << "-";
+					}
+					break;
+				case 4:
+					if (il[i].Commit < clock_cycles)
+					{
+						cout << setw(7) << to_string(il[i].Commit) << endl;
+					}
+					else
+					{
+						cout << setw(7) << "-" << endl;
+					}
+					break;
+				}
+			}
+		}
+	}
+}
+
+void sim_ooo::set_instruction_log_limit(unsigned long long entries)
+{
+	instruction_log_limit = entries;
+	if (instruction_log_length > entries) // drop the entries past the new limit
+	{
+		instruction_log_length = entries;
+	}
+}
+
+void sim_ooo::print_sampling_stats()
+{
+	double cpi = get_sampled_CPI();
+	double error = get_sampled_CPI_error();
+	cout << "SAMPLING STATISTICS" << endl;
+	cout << dec << "Samples = " << sample_count << endl;
+	cout << "CPI = " << cpi << " +/- " << error << " (95% confidence)" << endl;
+	if (cpi > error)
+	{
+		cout << "IPC = " << 1 / cpi << " [" << 1 / (cpi + error) << ", " << 1 / (cpi - error) << "]" << endl;
+	}
+}
+
+void sim_ooo::print_extrapolation_stats()
+{
+	cout << "LOOP EXTRAPOLATION" << endl;
+	cout << dec << "Extrapolations = " << extrapolations << endl;
+	cout << "Iterations = " << extrapolated_iterations << endl;
+	cout << "Instructions = " << extrapolated_instructions << " of " << instruction_count << endl;
+	cout << "Cycles = " << extrapolated_cycles << " of " << clock_cycles << endl;
+}
+
+void sim_ooo::print_commit_stats()
+{
+	cout << "COMMIT STATISTICS" << endl;
+	cout << dec << "Commit width = " << commit_max << endl;
+	cout << "Cycles limited by the commit width = " << commit_width_limited << endl;
+	cout << "Cycles blocked by the rob head = " << commit_head_blocked << endl;
+}
+
+void sim_ooo::print_lsq_stats()
+{
+	cout << "LOAD/STORE QUEUE" << endl;
+	cout << dec << "Loads forwarded from stores = " << forwarded_loads << endl;
+	cout << "Loads delayed by older stores = " << memory_conflicts << endl;
+}
+
+void sim_ooo::print_branch_stats()
+{
+	cout << "BRANCH PREDICTION" << endl;
+	cout << "Predictor = " << predictor_names[predictor != NULL ? predictor->kind : PREDICT_NOT_TAKEN];
+	if (predictor != NULL)
+	{
+		cout << dec << " (" << (1u << predictor->index_bits) << " entries, BTB " << predictor->btb_size << " entries)";
+	}
+	cout << endl;
+	cout << dec << "Branches = " << branches << endl;
+	cout << "Mispredictions = " << mispredictions << endl;
+	cout << "BTB misses = " << btb_misses << endl;
+	cout << "Rename checkpoints = " << rename_checkpoints << " (stalled " << checkpoint_stalls << " cycles)" << endl;
+	cout << "Accuracy = " << get_branch_accuracy() * 100 << "%" << endl;
+	cout << "MPKI = " << get_MPKI() << endl;
+}
+
+float sim_ooo::get_IPC()
+{
+	return (float)((double)instruction_count / (double)clock_cycles);
+}
+	
+unsigned sim_ooo::get_instructions_executed()
+{
+	return (unsigned)instruction_count;
+}
+
+unsigned sim_ooo::get_clock_cycles()
+{
+	return (unsigned)clock_cycles;
+}
+
+unsigned long long sim_ooo::get_instructions_executed64()
+{
+	return instruction_count;
+}
+
+unsigned long long sim_ooo::get_clock_cycles64()
+{
+	return clock_cycles;
+}
+
+unsigned long long sim_ooo::get_extrapolations()
+{
+	return extrapolations;
+}
+
+unsigned long long sim_ooo::get_extrapolated_iterations()
+{
+	return extrapolated_iterations;
+}
+
+unsigned long long sim_ooo::get_extrapolated_instructions()
+{
+	return extrapolated_instructions;
+}
+
+unsigned long long sim_ooo::get_extrapolated_cycles()
+{
+	return extrapolated_cycles;
+}
+
+unsigned long long sim_ooo::get_commit_width_limited_cycles()
+{
+	return commit_width_limited;
+}
+
+unsigned long long sim_ooo::get_commit_head_blocked_cycles()
+{
+	return commit_head_blocked;
+}
+
+unsigned long long sim_ooo::get_branches()
+{
+	return branches;
+}
+
+unsigned long long sim_ooo::get_mispredictions()
+{
+	return mispredictions;
+}
+
+unsigned long long sim_ooo::get_btb_misses()
+{
+	return btb_misses;
+}
+
+unsigned long long sim_ooo::get_checkpoint_stalls()
+{
+	return checkpoint_stalls;
+}
+
+unsigned long long sim_ooo::get_forwarded_loads()
+{
+	return forwarded_loads;
+}
+
+unsigned long long sim_ooo::get_memory_conflicts()
+{
+	return memory_conflicts;
+}
+
+double sim_ooo::get_branch_accuracy()
+{
+	return branches != 0 ? 1.0 - (double)mispredictions / branches : 1.0;
+}
+
+double sim_ooo::get_MPKI()
+{
+	return instruction_count != 0 ? 1000.0 * mispredictions / instruction_count : 0.0;
+}
+
+unsigned sim_ooo::get_samples()
+{
+	return sample_count;
+}
+
+double sim_ooo::get_sampled_CPI()
+{
+	return sample_count == 0 ? 0 : sample_cpi_sum / sample_count;
+}
+
+double sim_ooo::get_sampled_CPI_error()
+{
+	if (sample_count < 2)
+	{
+		return 0;
+	}
+	double mean = sample_cpi_sum / sample_count;
+	double variance = (sample_cpi_square_sum - sample_count * mean * mean) / (sample_count - 1);
+	if (variance < 0) // rounding when every sample is the same
+	{
+		variance = 0;
+	}
+	double t = sample_count - 1 <= 30 ? student_t_95[sample_count - 2] : 1.960;
+	return t * sqrt(variance / sample_count);
+}
+
+unsigned sim_ooo::get_register_value(std::string str)
+{
+	unsigned index = 0;
+	if (str.find('R') != std::string::npos) 
+	{
+		index = str.find_first_of('R');
+	}
+	else if (str.find('r') != std::string::npos)
+	{
+		index = str.find_first_of('r');
+	}
+	else if (str.find('F') != std::string::npos)
+	{
+		index = str.find_first_of('F');
+	}
+	else if (str.find('f') != std::string::npos)
+	{
+		index = str.find_first_of('f');
+	}
+	string reg = str.substr(index + 1);
+	int value = strtoul(reg.c_str(), NULL, 10);
+	return value;
+}
+
+unsigned sim_ooo::get_first_letter(std::string str, unsigned start)
+
+{
+	unsigned index = start;
+	unsigned i;
+	for (i = start; i < str.length(); i++)
+	{
+		if (str[i] != '	' && str[i] != ' ')
+		{
+			index = i;
+			break;
+		}
+	}
+	return index;
+}
+
+unsigned sim_ooo::find_end_of_argument(std::string str, unsigned start)
+{
+	unsigned index = start;
+	unsigned i;
+	for (i = start; i < str.length(); i++)
+	{
+		if (str[i] == '	' || str[i] == ' ')
+		{
+			index = i;
+			break;
+		}
+	}
+	if (i == str.length())
+	{
+		index = str.length() + 1;
+	}
+	return index;
+}
+
+int sim_ooo::convert_string_to_number(std::string str)
+{
+	int imm = 0;
+	if (str.find('b') < str.length())
+	{
+		str = str.substr(2);
+		imm = strtoul(str.c_str(), NULL, 2);
+	}
+	else if ((str.find('x') < str.length()) || (str.find('X') < str.length()))
+	{
+		str = str.substr(2);
+		imm = strtoul(str.c_str(), NULL, 16);
+	}
+	else if (str.find('d') < str.length())
+	{
+		str = str.substr(2);
+		imm = strtoul(str.c_str(), NULL, 10);
+	}
+	else
+	{
+		str = str.substr(0);
+		imm = strtoul(str.c_str(), NULL, 10);
+	}
+	return imm;
+}
+
+void sim_ooo::print_instruction_memory(unsigned start_address, unsigned end_address) {
+	cout << "instruction_memory[0x" << hex << setw(8) << setfill('0') << start_address << ":0x" << hex << setw(8) << setfill('0') << end_address << "]" << endl;
+	unsigned i;
+	for (i = instruction_memory_size; i<instruction_memory_size + 100; i++) {
+		if (i % 1 == 0) cout << "0x" << hex << setw(8) << setfill('0') << i << ": ";
+		cout << hex << setw(2) << setfill('0') << int(instruction_memory[i]) << " ";
+		if (i % 4 == 3) cout << endl;
+	}
+}
+
+void sim_ooo::set_branch_predictor(predictor_t kind, unsigned index_bits, unsigned btb_entries)
+{
+	delete_predictor(predictor);
+	predictor = NULL;
+	if (kind != PREDICT_NOT_TAKEN)
+	{
+		if (index_bits == 0)
+		{
+			index_bits = 1;
+		}
+		else if (index_bits > MAX_PREDICTOR_BITS)
+		{
+			index_bits = MAX_PREDICTOR_BITS;
+		}
+		unsigned btb_size = 1;
+		while (btb_size < btb_entries && btb_size < (1u << MAX_PREDICTOR_BITS))
+		{
+			btb_size <<= 1;
+		}
+		predictor = new_predictor(kind, index_bits, btb_size);
+	}
+	branches = mispredictions = btb_misses = 0;
+	loop_body_length = loop_last_length = UNDEFINED; // the timing of the current iteration changes
+}
+
+unsigned sim_ooo::predict_branch(unsigned entry, unsigned pc)
+{
+	read_order_buffer &branch = rob[entry];
+	branch.predicted_taken = false;
+	branch.btb_miss = false;
+	branch.history = 0;
+	if (predictor == NULL)
+	{
+		return pc + 1;
+	}
+	bool conditional = branch.opcode != JUMP;
+	branch.history = predictor->history;
+	bool taken = !conditional || predict_direction(*predictor, pc, predictor->history);
+	unsigned target = pc + 1;
+	if (taken && !btb_lookup(*predictor, pc, target)) // no target to fetch from: issue falls through
+	{
+		branch.btb_miss = true;
+		taken = false;
+	}
+	branch.predicted_taken = taken;
+	if (conditional && predictor->kind != PREDICT_BIMODAL)
+	{
+		predictor->history = (predictor->history << 1) | taken;
+	}
+	return taken ? target : pc + 1;
+}
+
+void sim_ooo::train_branch(unsigned entry, bool taken)
+{
+	branches++;
+	if (taken != rob[entry].predicted_taken || rob[entry].mispredicted)
+	{
+		mispredictions++;
+	}
+	if (rob[entry].btb_miss)
+	{
+		btb_misses++;
+	}
+	if (predictor != NULL)
+	{
+		train_predictor(*predictor, rob[entry].pc / 4, rob[entry].opcode != JUMP, rob[entry].history, taken,
+			(rob[entry].value - 4) / 4);
+	}
+}
+
+void sim_ooo::set_early_resolution(bool enabled)
+{
+	early_resolution = enabled;
+	loop_body_length = loop_last_length = UNDEFINED; // the timing of the current iteration changes
+}
+
+void sim_ooo::recover_branch(unsigned entry)
+{
+	read_order_buffer &branch = rob[entry];
+	unsigned long long seq = branch.seq;
+	bool taken = branch.opcode == JUMP || branch.value != (int)branch.pc + 4;
+	branch.mispredicted = true;
+
+	// stations of younger instructions leave the waiter lists of the entries they wait on, then are freed
+	unsigned total_rs = size_of_int_rs + size_of_add_rs + size_of_mult_rs + size_of_load_rs;
+	for (unsigned i = 0; i < size_of_rob; i++)
+	{
+		unsigned *link = &rob[i].waiters;
+		while (*link != UNDEFINED)
+		{
+			reservation_station &rs = all_rs[*link / 2];
+			unsigned *next = *link % 2 == 0 ? &rs.next_j : &rs.next_k;
+			if (rs.busy && rob[rs.dest].seq > seq)
+			{
+				*link = *next;
+			}
+			else
+			{
+				link = next;
 			}
 		}
 	}
-	// print out add_rs
-	for (unsigned i = 0; i < size_of_add_rs; i++)
+	for (unsigned i = 0; i < total_rs; i++)
 	{
-		for (unsigned j = 0; j < 9; j++)
+		if (all_rs[i].busy && rob[all_rs[i].dest].seq > seq)
 		{
-			switch (j)
+			clear_ready(i);
+			touch_rs(i);
+			all_rs[i] = clear_rs(all_rs[i].name);
+		}
+	}
+
+	// units executing younger instructions leave the timing wheel; those that wrote this cycle are freed next cycle
+	for (unsigned slot = 0; slot < wheel_size; slot++)
+	{
+		ex_unit **link = &wheel[slot];
+		while (*link != NULL)
+		{
+			ex_unit *ex = *link;
+			if (rob[ex->entry].seq > seq)
 			{
-			case 0:
-				cout << setw(7) << add_rs[i].name << setw(6);
-				break;
-			case 1:
-				if (add_rs[i].busy)
-				{
-					cout << "yes";
-				}
-				else
-				{
-					cout << "no";
-				}
-				break;
-			case 2:
-				if (add_rs[i].pc < 10000000)
-				{
-					cout << setw(4) << hex << "0x" << setw(8) << setfill('0') << add_rs[i].pc << setfill(' ');
-				}
-				else
-				{
-					cout << setw(12) << "-" << setw(8);
-				}
-				break;
-			case 3:
-				if (add_rs[i].opcode == ADDS || add_rs[i].opcode == SUBS)
-				{
-					if (add_rs[i].vjf < 100000.00 && add_rs[i].vjf > -100000.00 && add_rs[i].vjf != unsigned2float(UNDEFINED))
-					{
-						cout << setw(4) << hex << "0x" << setw(8) << setfill('0') << float2unsigned(add_rs[i].vjf) << setfill(' ');
-					}
-					else
-					{
-						cout << setw(12) << "-" << setw(8);
-					}
-				}
-				else
-				{
-					if (add_rs[i].vj < 100000 && add_rs[i].vj > -100000 && add_rs[i].vj != (UNDEFINED))
-					{
-						cout << setw(4) << hex << "0x" << setw(8) << setfill('0') << add_rs[i].vj << setfill(' ');
-					}
-					else
-					{
-						cout << setw(12) << "-" << setw(8);
-					}
-				}
-				break;
-			case 4:
-				if (add_rs[i].opcode == ADDS || add_rs[i].opcode == SUBS)
-				{
-					if (add_rs[i].vkf < 100000.00 && add_rs[i].vkf > -100000.00 && add_rs[i].vkf != unsigned2float(UNDEFINED))
-					{
-						cout << setw(4) << hex << "0x" << setw(8) << setfill('0') << float2unsigned(add_rs[i].vkf) << setfill(' ');
-					}
-					else
-					{
-						cout << setw(12) << "-" << setw(8);
-					}
-				}
-				else
-				{
-					if (add_rs[i].vk < 100000 && add_rs[i].vk > -100000 && add_rs[i].vk != (UNDEFINED))
-					{
-						cout << setw(4) << hex << "0x" << setw(8) << setfill('0') << add_rs[i].vk << setfill(' ');
-					}
-					else
-					{
-						cout << setw(12) << "-" << setw(8);
-					}
-				}
-				break;
-			case 5:
-				if (add_rs[i].qj < 32)
-				{
-					cout << setw(6) << to_string(add_rs[i].qj);
-				}
-				else
-				{
-					cout << setw(6) << "-";
-				}
-				break;
-			case 6:
-				if (add_rs[i].qk < 32)
-				{
-					cout << setw(6) << to_string(add_rs[i].qk);
-				}
-				else
-				{
-					cout << setw(6) << "-";
-				}
-				break;
-			case 7:
-				if (add_rs[i].dest < size_of_rob)
-				{
-					cout << setw(6) << to_string(add_rs[i].dest);
-				}
-				else
-				{
-					cout << setw(6) << "-";
-				}
-				break;
-			case 8:
-				cout << setw(12) << "-" << setw(8) << endl;
-				break;
+				*link = ex->next;
+				*ex = clear_ex_unit(ex->name, ex->delay, ex->type);
+			}
+			else
+			{
+				link = &ex->next;
 			}
 		}
 	}
-	// print out mult_rs
-	for (unsigned i = 0; i < size_of_mult_rs; i++)
+
+	// the rob is cut after the branch; its entries and the checkpoints of the branches among them can be reused right away
+	unsigned kept = (entry + size_of_rob - rob_head) % size_of_rob + 1;
+	for (unsigned i = kept; i < rob_count; i++)
 	{
-		for (unsigned j = 0; j < 9; j++)
+		unsigned pos = (rob_head + i) % size_of_rob;
+		if (rob[pos].checkpointed)
 		{
-			switch (j)
-			{
-			case 0:
-				cout << setw(7) << mult_rs[i].name << setw(6);
-				break;
-			case 1:
-				if (mult_rs[i].busy)
-				{
-					cout << "yes";
-				}
-				else
-				{
-					cout << "no";
-				}
-				break;
-			case 2:
-				if (mult_rs[i].pc < 10000000)
-				{
-					cout << setw(4) << hex << "0x" << setw(8) << setfill('0') << mult_rs[i].pc << setfill(' ');
-				}
-				else
-				{
-					cout << setw(12) << "-" << setw(8);
-				}
-				break;
-			case 3:
-				if (mult_rs[i].opcode == MULTS || mult_rs[i].opcode == DIVS)
-				{
-					if (mult_rs[i].vjf < 100000.00 && mult_rs[i].vjf > -100000.00 && mult_rs[i].vjf != unsigned2float(UNDEFINED))
-					{
-						cout << setw(4) << hex << "0x" << setw(8) << setfill('0') << float2unsigned(mult_rs[i].vjf) << setfill(' ');
-					}
-					else
-					{
-						cout << setw(12) << "-" << setw(8);
-					}
-				}
-				else
-				{
-					if (mult_rs[i].vj < 100000 && mult_rs[i].vj > -100000 && mult_rs[i].vj != (UNDEFINED))
-					{
-						cout << setw(4) << hex << "0x" << setw(8) << setfill('0') << mult_rs[i].vj << setfill(' ');
-					}
-					else
-					{
-						cout << setw(12) << "-" << setw(8);
-					}
-				}
+			checkpoints_in_use--;
+		}
+		rob[pos] = clear_rob_entry(pos);
+		rob[pos].waiters = UNDEFINED;
+		rob[pos].commit_stall = false;
+		iq[pos].pc = UNDEFINED;
+		iq[pos].Issue = UNDEFINED_CYCLE;
+		iq[pos].Exe = UNDEFINED_CYCLE;
+		iq[pos].WR = UNDEFINED_CYCLE;
+		iq[pos].Commit = UNDEFINED_CYCLE;
+	}
+	rob_count = kept;
+	rob_tail = (entry + 1) % size_of_rob;
+	restore_rename_map(entry);
+
+	// issue goes on from the correct path, with the history the branch leaves
+	pc = taken ? (branch.value - 4) / 4 : branch.pc / 4 + 1;
+	if (front != NULL && branch.traced) // the branch is on the program path, so issue is back on it
+	{
+		front->wrong_path = false;
+	}
+	if (predictor != NULL)
+	{
+		predictor->history = branch.history;
+		if (branch.opcode != JUMP && predictor->kind != PREDICT_BIMODAL)
+		{
+			predictor->history = (predictor->history << 1) | taken;
+		}
+	}
+}
+
+void sim_ooo::set_rename_checkpoints(unsigned count)
+{
+	rename_checkpoints = count != 0 && count < size_of_rob ? count : size_of_rob;
+	checkpoint_stalls = 0;
+	loop_body_length = loop_last_length = UNDEFINED; // the timing of the current iteration changes
+}
+
+void sim_ooo::save_rename_map(unsigned entry)
+{
+	unsigned *map = rename_map + entry * 2 * NUM_GP_REGISTERS;
+	for (unsigned i = 0; i < NUM_GP_REGISTERS; i++)
+	{
+		map[i] = int_reg[i].entry;
+		map[NUM_GP_REGISTERS + i] = fp_reg[i].entry;
+	}
+	rob[entry].checkpointed = true;
+	checkpoints_in_use++;
+}
+
+void sim_ooo::restore_rename_map(unsigned entry)
+{
+	// the entries younger than the branch are empty by now, so a saved producer that is still busy is the same instruction
+	const unsigned *map = rename_map + entry * 2 * NUM_GP_REGISTERS;
+	for (unsigned i = 0; i < NUM_GP_REGISTERS; i++)
+	{
+		unsigned int_entry = map[i], fp_entry = map[NUM_GP_REGISTERS + i];
+		int_reg[i].entry = int_entry != UNDEFINED && rob[int_entry].busy ? int_entry : UNDEFINED;
+		fp_reg[i].entry = fp_entry != UNDEFINED && rob[fp_entry].busy ? fp_entry : UNDEFINED;
+	}
+}
+
+bool sim_ooo::branchIf(unsigned opcode, unsigned a)
+{
+	bool condition = false;
+	if (opcode == BEQZ && a == 0)
+	{
+		condition = true;
+	}
+	else if (opcode == BNEZ && a != 0)
+	{
+		condition = true;
+	}
+	else if (opcode == BLTZ && a < 0)
+	{
+		condition = true;
+	}
+	else if (opcode == BGTZ && a > 0)
+	{
+		condition = true;
+	}
+	else if (opcode == BLEZ && a <= 0)
+	{
+		condition = true;
+	}
+	else if (opcode == BGEZ && a >= 0)
+	{
+		condition = true;
+	}
+	return condition;
+}
+
+void sim_ooo::issue()
+{
+	for (unsigned i = 0; i < issue_max; i++)
+	{
+		int open_rob = get_open_rob(rob);
+		unsigned pc_entry = pc * 4;
+		if (open_rob == -1) // if no open re-order buffer we stall the issue stage
+		{
+			return;
+		}
+		if (pc >= decoded_memory_size) // nothing left to fetch past the end of instruction memory
+		{
+			return;
+		}
+		const decoded_instruction &inst = decoded_memory[pc];
+		unsigned opcode = inst.opcode;
+		bool int_or_float = inst.int_or_float;
+		unsigned next_pc = pc + 1;
+		unsigned vj = UNDEFINED, vk = UNDEFINED, qj = UNDEFINED, qk = UNDEFINED, a = UNDEFINED;
+		float vjf = unsigned2float(UNDEFINED), vkf = unsigned2float(UNDEFINED);
+
+		if (inst.station == LOAD_B)
+		{
+			int open_rs = get_open_rs(load_rs);
+			if (open_rs == -1) // if no open reservation station we stall the issue stage
+			{
+				return;
+			}
+			vj = get_int_register(inst.src1); // base register is always an integer register
+			qj = get_q(inst.src1, true);
+			a = inst.imm;
+			write_to_rob_issue(opcode, open_rob, pc_entry, inst.dest, int_or_float); // writes the instruction to the rob
+			if (opcode == SW || opcode == SWS) // loads forwarded from the store find its value through the producer
+			{
+				rob[open_rob].data_entry = opcode == SW ? get_pending_int_register(inst.dest) : get_pending_fp_register(inst.dest);
+			}
+			write_to_rs(open_rs, LOAD_B, opcode, int_or_float, vj, vk, vjf, vkf, qj, qk, pc_entry, a, open_rob);
+			trace_issue(open_rob, pc);
+		}
+		else if (inst.station != 0)
+		{
+			reservation_station *rs;
+			switch (inst.station)
+			{
+			case ADD_RS:
+				rs = add_rs;
 				break;
-			case 4:
-				if (mult_rs[i].opcode == MULTS || mult_rs[i].opcode == DIVS)
-				{
-					if (mult_rs[i].vkf < 100000.00 && mult_rs[i].vkf > -100000.00 && mult_rs[i].vkf != unsigned2float(UNDEFINED))
-					{
-						cout << setw(4) << hex << "0x" << setw(8) << setfill('0') << float2unsigned(mult_rs[i].vkf) << setfill(' ');
-					}
-					else
-					{
-						cout << setw(12) << "-" << setw(8);
-					}
-				}
-				else
-				{
-					if (mult_rs[i].vk < 100000 && mult_rs[i].vk > -100000 && mult_rs[i].vk != (UNDEFINED))
-					{
-						cout << setw(4) << hex << "0x" << setw(8) << setfill('0') << mult_rs[i].vk << setfill(' ');
-					}
-					else
-					{
-						cout << setw(12) << "-" << setw(8);
-					}
-				}
+			case MULT_RS:
+				rs = mult_rs;
 				break;
-			case 5:
-				if (mult_rs[i].qj < 32)
-				{
-					cout << setw(6) << to_string(mult_rs[i].qj);
-				}
-				else
-				{
-					cout << setw(6) << "-";
-				}
+			default:
+				rs = int_rs;
 				break;
-			case 6:
-				if (mult_rs[i].qk < 32)
+			}
+			int open_rs = get_open_rs(rs);
+			if (open_rs == -1) // if no open reservation station we stall the issue stage
+			{
+				return;
+			}
+			if (inst.target != UNDEFINED && checkpoints_in_use == rename_checkpoints) // nor can a branch issue without a checkpoint
+			{
+				checkpoint_stalls++;
+				return;
+			}
+			if (inst.src1 != UNDEFINED)
+			{
+				if (int_or_float)
 				{
-					cout << setw(6) << to_string(mult_rs[i].qk);
+					vj = get_int_register(inst.src1);
 				}
 				else
 				{
-					cout << setw(6) << "-";
+					vjf = get_fp_register(inst.src1);
 				}
-				break;
-			case 7:
-				if (mult_rs[i].dest < size_of_rob)
+				qj = get_q(inst.src1, int_or_float);
+			}
+			if (inst.src2 != UNDEFINED)
+			{
+				if (int_or_float)
 				{
-					cout << setw(6) << to_string(mult_rs[i].dest);
+					vk = get_int_register(inst.src2);
 				}
 				else
 				{
-					cout << setw(6) << "-";
+					vkf = get_fp_register(inst.src2);
 				}
-				break;
-			case 8:
-				cout << setw(12) << "-" << setw(8) << endl;
-				break;
+				qk = get_q(inst.src2, int_or_float);
 			}
+			else if (inst.imm != UNDEFINED)
+			{
+				vk = inst.imm;
+			}
+			if (inst.target != UNDEFINED)
+			{
+				a = inst.target;
+			}
+			write_to_rob_issue(opcode, open_rob, pc_entry, inst.dest, int_or_float); // writes the instruction to the rob
+			write_to_rs(open_rs, inst.station, opcode, int_or_float, vj, vk, vjf, vkf, qj, qk, pc_entry, a, open_rob);
+			if (inst.target != UNDEFINED) // branches and jumps
+			{
+				save_rename_map(open_rob);
+				next_pc = predict_branch(open_rob, pc);
+			}
+			trace_issue(open_rob, pc);
+		}
+		if (next_pc != pc + 1) // a branch predicted taken ends the issue group, which goes on from its target next cycle
+		{
+			pc = next_pc;
+			return;
 		}
+		pc++;
 	}
-	cout << endl;
 }
 
-void sim_ooo::print_pending_instructions(){
-	cout << "PENDING INSTRUCTIONS STATUS" << endl;
-	cout << setfill(' ');
-	cout << setw(10) << "PC" << setw(7) << "Issue" << setw(7) << "Exe" << setw(7) << "WR" << setw(7) << "Commit";
-	cout << endl;
+void sim_ooo::execute()
+{
+	dispatch(int_ex, size_of_int_ex, INTEGER);
+	dispatch(add_ex, size_of_add_ex, ADDER);
+	dispatch(mem_ex, size_of_mem_ex, MEMORY);
+	dispatch(mult_ex, size_of_mult_ex, MULTIPLIER);
+	dispatch(div_ex, size_of_div_ex, DIVIDER);
+}
 
-	for (unsigned i = 0; i < size_of_rob; i++)
+void sim_ooo::dispatch(ex_unit *ex, unsigned size, unsigned unit)
+{
+	// check to see if any open exe units
+	unsigned i;
+	for (i = 0; i < size; i++)
 	{
-		for (unsigned j = 0; j < 5; j++)
+		if (!ex[i].busy)
 		{
-			switch (j)
+			break; // we have an open ex_unit so end loop
+		}
+	}
+	if (i == size)
+	{
+		return;
+	}
+
+	// station with the lowest index whose instruction has all the values necessary to compute
+	int station = unit == MEMORY ? first_ready_memory() : first_ready(unit);
+	if (station == -1)
+	{
+		return;
+	}
+	clear_ready(station);
+	reservation_station &rs = all_rs[station];
+
+	//move the instruction in the exe unit
+	unsigned rob_entry = rs.dest;
+	rob[rob_entry].state = EXECUTE;
+	iq[rob_entry].Exe = clock_cycles;
+	write_to_il(rob[rob_entry].log_index, 2);
+	if (rs.opcode == EOP)
+	{
+		iq[rob_entry].Exe = UNDEFINED_CYCLE;
+	}
+	ex[i].busy = true;
+	schedule_ex_unit(&ex[i]);
+	ex[i].entry = rs.dest;
+	ex[i].opcode = rs.opcode;
+	ex[i].vj = rs.vj;
+	ex[i].pc = rs.pc;
+	if (unit == MEMORY)
+	{
+		ex[i].vk = rs.a;
+		rs.a = ex[i].vj + ex[i].vk; // the buffer now shows the effective address
+		return;
+	}
+	if (rs.opcode == BEQZ || rs.opcode == BNEZ || rs.opcode == BLTZ
+		|| rs.opcode == BGTZ || rs.opcode == BLEZ || rs.opcode == BGEZ
+		|| rs.opcode == JUMP) // if a branch instruction write address to vk for computation
+	{
+		ex[i].vk = rs.a;
+	}
+	else
+	{
+		ex[i].vk = rs.vk;
+	}
+	ex[i].vjf = rs.vjf;
+	ex[i].vkf = rs.vkf;
+}
+
+void sim_ooo::set_ready(unsigned station)
+{
+	ready_rs[(all_rs[station].unit - 1) * ready_words + station / 64] |= 1ULL << (station % 64);
+}
+
+void sim_ooo::clear_ready(unsigned station)
+{
+	for (unsigned unit = 0; unit < NUM_EXE_UNITS; unit++)
+	{
+		ready_rs[unit * ready_words + station / 64] &= ~(1ULL << (station % 64));
+	}
+}
+
+int sim_ooo::first_ready(unsigned unit)
+{
+	unsigned long long *mask = ready_rs + (unit - 1) * ready_words;
+	for (unsigned w = 0; w < ready_words; w++)
+	{
+		if (mask[w] != 0)
+		{
+			unsigned bit = 0;
+			while (!(mask[w] & (1ULL << bit)))
 			{
-			case 0:
-				if (iq[i].pc != UNDEFINED)
-				{
-					cout << setw(2) << hex << "0x" << setw(8) << setfill('0') << iq[i].pc << setfill(' ');
-				}
-				else
-				{
-					cout << setw(10) << "-";
-				}
-				break;
-			case 1:
-				if (iq[i].Issue != UNDEFINED)
-				{
-					cout << setw(7) << to_string(iq[i].Issue);
-				}
-				else
-				{
-					cout << setw(7) << "-";
-				}
-				break;
-			case 2:
-				if (iq[i].Exe != UNDEFINED)
-				{
-					cout << setw(7) << to_string(iq[i].Exe);
-				}
-				else
-				{
-					cout << setw(7) << "-";
-				}
-				break;
-			case 3:
-				if (iq[i].WR != UNDEFINED)
-				{
-					cout << setw(7) << to_string(iq[i].WR);
-				}
-				else
-				{
-					cout << setw(7) << "-";
-				}
-				break;
-			case 4:
-				if (iq[i].Commit != UNDEFINED)
-				{
-					cout << setw(7) << to_string(iq[i].Commit) << endl;
-				}
-				else
-				{
-					cout << setw(7) << "-" << endl;
-				}
-				break;
+				bit++;
 			}
+			return w * 64 + bit;
 		}
 	}
-	cout << endl;
+	return -1;
 }
 
-void sim_ooo::print_log()
+int sim_ooo::first_ready_memory()
 {
-	cout << "EXECUTION LOG" << endl;
-	cout << setfill(' ');
-	cout << setw(10) << "PC" << setw(7) << "Issue" << setw(7) << "Exe" << setw(7) << "WR" << setw(7) << "Commit";
-	cout << endl;
-
-	for (unsigned i = 0; i < instruction_log_length; i++)
+	unsigned long long *mask = ready_rs + (MEMORY - 1) * ready_words;
+	for (unsigned w = 0; w < ready_words; w++)
 	{
-		for (unsigned j = 0; j < 5; j++)
+		for (unsigned long long bits = mask[w]; bits != 0; bits &= bits - 1)
 		{
-			if (il[i].pc < final_pc)
+			unsigned bit = 0;
+			while (!(bits & (1ULL << bit)))
 			{
-				switch (j)
-				{
-				case 0:
-					if (il[i].pc != UNDEFINED)
-					{
-						cout << setw(2) << hex << "0x" << setw(8) << setfill('0') << il[i].pc << setfill(' ');
-					}
-					else
-					{
-						cout << setw(10) << "-";
-					}
-					break;
-				case 1:
-					if (il[i].Issue < clock_cycles)
-					{
-						cout << setw(7) << to_string(il[i].Issue);
-					}
-					else
-					{
-						cout << setw(7) << "-";
-					}
-					break;
-				case 2:
-					if (il[i].Exe < clock_cycles)
-					{
-						cout << setw(7) << to_string(il[i].Exe);
-					}
-					else
-					{
-						cout << setw(7) << "-";
-					}
-					break;
-				case 3:
-					if (il[i].WR < clock_cycles)
-					{
-						cout << setw(7) << to_string(il[i].WR);
-					}
-					else
-					{
-						cout << setw(7) << "-";
-					}
-					break;
-				case 4:
-					if (il[i].Commit < clock_cycles)
-					{
-						cout << setw(7) << to_string(il[i].Commit) << endl;
-					}
-					else
-					{
-						cout << setw(7) << "-" << endl;
-					}
-					break;
-				}
+				bit++;
+			}
+			const reservation_station &rs = all_rs[w * 64 + bit];
+			if (rs.opcode != LW && rs.opcode != LWS)
+			{
+				return w * 64 + bit;
+			}
+			bool blocked;
+			find_older_store(rs.dest, rs.vj + rs.a, blocked);
+			if (!blocked)
+			{
+				return w * 64 + bit;
+			}
+			if (!rob[rs.dest].delayed) // counted once per load, however long it waits
+			{
+				rob[rs.dest].delayed = true;
+				memory_conflicts++;
 			}
 		}
 	}
+	return -1;
 }
 
-float sim_ooo::get_IPC()
+unsigned sim_ooo::find_older_store(unsigned load, unsigned address, bool &blocked)
 {
-	return instruction_count / clock_cycles;
+	blocked = false;
+	for (unsigned i = (load + size_of_rob - rob_head) % size_of_rob; i > 0; i--) // youngest to oldest
+	{
+		unsigned pos = (rob_head + i - 1) % size_of_rob;
+		const read_order_buffer &store = rob[pos];
+		if (store.opcode != SW && store.opcode != SWS)
+		{
+			continue;
+		}
+		if (!store.ready) // the address is computed when the store writes its result
+		{
+			blocked = true;
+			return UNDEFINED;
+		}
+		unsigned store_address = store.value;
+		if (store_address == address)
+		{
+			unsigned producer = store.data_entry;
+			blocked = producer != UNDEFINED && rob[producer].busy && rob[producer].seq < store.seq && !rob[producer].ready;
+			return blocked ? UNDEFINED : pos;
+		}
+		if ((store_address > address ? store_address - address : address - store_address) < 4) // read once it is in memory
+		{
+			blocked = true;
+			return UNDEFINED;
+		}
+	}
+	return UNDEFINED;
 }
-	
-unsigned sim_ooo::get_instructions_executed()
+
+unsigned sim_ooo::store_data(unsigned entry)
 {
-	return (unsigned)instruction_count;
+	const read_order_buffer &store = rob[entry];
+	unsigned producer = store.data_entry;
+	bool in_flight = producer != UNDEFINED && rob[producer].busy && rob[producer].seq < store.seq;
+	unsigned reg = register_index(store.destination);
+	if (store.opcode == SW)
+	{
+		return in_flight ? rob[producer].value : int_reg[reg].value;
+	}
+	return float2unsigned(in_flight ? rob[producer].value_f : fp_reg[reg].value);
 }
 
-unsigned sim_ooo::get_clock_cycles()
+void sim_ooo::touch_rs(unsigned station)
 {
-	return (unsigned)clock_cycles;
+	if (!all_rs[station].wb && !all_rs[station].cleared)
+	{
+		touched_rs[touched_count++] = station;
+	}
 }
 
-unsigned sim_ooo::get_register_value(std::string str)
+void sim_ooo::write_result()
 {
-	unsigned index = 0;
-	if (str.find('R') != std::string::npos) 
+	// units that wrote their result last cycle are free again
+	while (releasing != NULL)
 	{
-		index = str.find_first_of('R');
+		ex_unit *ex = releasing;
+		releasing = ex->next;
+		*ex = clear_ex_unit(ex->name, ex->delay, ex->type);
 	}
-	else if (str.find('r') != std::string::npos)
+	if (wheel_size == 0)
 	{
-		index = str.find_first_of('r');
+		return;
 	}
-	else if (str.find('F') != std::string::npos)
+
+	// only the units finishing this cycle are visited
+	unsigned slot = (unsigned)clock_cycles & (wheel_size - 1);
+	ex_unit *ex = wheel[slot];
+	wheel[slot] = NULL;
+	while (ex != NULL)
 	{
-		index = str.find_first_of('F');
+		ex_unit *next = ex->next;
+		write_unit_result(*ex);
+		ex->next = releasing;
+		releasing = ex;
+		ex = next;
 	}
-	else if (str.find('f') != std::string::npos)
+	if (resolved_entry != UNDEFINED) // once every unit of the slot has been visited
 	{
-		index = str.find_first_of('f');
+		recover_branch(resolved_entry);
+		resolved_entry = UNDEFINED;
 	}
-	string reg = str.substr(index + 1);
-	int value = strtoul(reg.c_str(), NULL, 10);
-	return value;
 }
 
-unsigned sim_ooo::get_first_letter(std::string str, unsigned start)
-
+void sim_ooo::write_unit_result(ex_unit &ex)
 {
-	unsigned index = start;
-	unsigned i;
-	for (i = start; i < str.length(); i++)
+	// results of instructions on the program path come from the functional front when it runs
+	const dynamic_instruction *record = rob[ex.entry].traced ? &rob_trace[ex.entry] : NULL;
+	if (ex.type == INTEGER)
 	{
-		if (str[i] != '	' && str[i] != ' ')
+		int answer = record != NULL ? record->value : compute_result_int(ex);
+		if (ex.opcode == BEQZ || ex.opcode == BNEZ || ex.opcode == BLTZ || ex.opcode == BGTZ
+			|| ex.opcode == BLEZ || ex.opcode == BGEZ || ex.opcode == JUMP)
 		{
-			index = i;
-			break;
+			write_rob(answer, ex.entry);
+			bool taken = ex.opcode == JUMP || answer != (int)rob[ex.entry].pc + 4;
+			if (early_resolution && taken != rob[ex.entry].predicted_taken
+				&& (resolved_entry == UNDEFINED || rob[ex.entry].seq < rob[resolved_entry].seq))
+			{
+				resolved_entry = ex.entry;
+			}
+		}
+		else
+		{
+			write_rs(answer, ex.entry);
+			write_rob(answer, ex.entry);
 		}
 	}
-	return index;
+	else if (ex.type == MEMORY)
+	{
+		unsigned store = UNDEFINED;
+		if (ex.opcode == LW || ex.opcode == LWS) // the youngest older store to the same word supplies the value
+		{
+			bool blocked;
+			store = find_older_store(ex.entry, ex.vj + ex.vk, blocked);
+			if (store != UNDEFINED)
+			{
+				forwarded_loads++;
+			}
+		}
+		if (ex.opcode == LW || ex.opcode == SW || ex.opcode == SWS)
+		{
+			int answer = record != NULL ? record->value : store != UNDEFINED ? (int)store_data(store) : compute_address_int(ex);
+			if (ex.opcode == LW)
+			{
+				write_rs(answer, ex.entry);
+			}
+			write_rob(answer, ex.entry);
+		}
+		else
+		{
+			float answer = record != NULL ? record->value_f
+				: store != UNDEFINED ? unsigned2float(store_data(store)) : compute_address_fp(ex);
+			write_rs(answer, ex.entry);
+			write_rob(answer, ex.entry);
+		}
+	}
+	else if (record != NULL && (ex.opcode == MULT || ex.opcode == DIV)) // integer result on the MULT/DIV units
+	{
+		write_rs(record->value, ex.entry);
+		write_rob(record->value, ex.entry);
+	}
+	else // ADDER, MULTIPLIER and DIVIDER
+	{
+		float answer = record != NULL ? record->value_f : compute_result_fp(ex);
+		write_rs(answer, ex.entry);
+		write_rob(answer, ex.entry);
+	}
+	find_and_clear_rs(ex.entry);
+	write_to_il(rob[ex.entry].log_index, 3);
 }
 
-unsigned sim_ooo::find_end_of_argument(std::string str, unsigned start)
+void sim_ooo::schedule_ex_unit(ex_unit *ex)
 {
-	unsigned index = start;
-	unsigned i;
-	for (i = start; i < str.length(); i++)
+	// the unit writes its result "latency" cycles after the one it starts executing in
+	unsigned cycle = (unsigned)clock_cycles;
+	ex->finish = cycle + (ex->delay > 1 ? ex->delay - 1 : 1);
+	unsigned slot = ex->finish & (wheel_size - 1);
+	ex->next = wheel[slot];
+	wheel[slot] = ex;
+}
+
+void sim_ooo::commit()
+{
+	clear_write_back_check();
+	clear_commit_stall();
+	unsigned committed;
+	for (committed = 0; committed < commit_max && !eop; committed++) // in order, up to commit_max per cycle
 	{
-		if (str[i] == '	' || str[i] == ' ')
+		unsigned pos = rob_head; // oldest instruction in the rob
+		if (rob_count == 0 || !rob[pos].ready)
 		{
-			index = i;
 			break;
 		}
+		rob_head = (rob_head + 1) % size_of_rob;
+		rob_count--;
+		if (rob[pos].checkpointed)
+		{
+			checkpoints_in_use--;
+		}
+		write_to_il(rob[pos].log_index, 4);
+		if (loop_extrapolation)
+		{
+			track_loop(pos);
+		}
+		unsigned opcode = rob[pos].opcode;
+		if (opcode == BEQZ || opcode == BNEZ || opcode == BLTZ
+			|| opcode == BGTZ || opcode == BLEZ || opcode == BGEZ)
+		{
+			bool taken = rob[pos].value != (int)rob[pos].pc + 4;
+			train_branch(pos, taken);
+			if (taken != rob[pos].predicted_taken && !rob[pos].mispredicted) // issue went down the other path
+			{
+				pc = taken ? (rob[pos].value - 4) / 4 : rob[pos].pc / 4 + 1;
+				flush_rob();
+				flush_ex();
+				flush_rs();
+			}
+		}
+		else if (opcode == JUMP)
+		{
+			train_branch(pos, true);
+			if (!rob[pos].predicted_taken && !rob[pos].mispredicted) // the instructions issued after the jump are not on the program path
+			{
+				pc = (rob[pos].value - 4) / 4;
+				flush_rob();
+				flush_ex();
+				flush_rs();
+			}
+		}
+		else if (opcode == SW || opcode == SWS)
+		{
+			write_memory(rob[pos].value, store_data(pos));
+		}
+		else if (opcode == LW)
+		{
+			unsigned reg = register_index(rob[pos].destination);
+			if (int_reg[reg].entry == pos)
+			{
+				int_reg[reg].value = rob[pos].value;
+				int_reg[reg].entry = UNDEFINED;
+			}
+			else if (int_reg[reg].entry == UNDEFINED || rob[pos].seq < rob[int_reg[reg].entry].seq)
+			{
+				int_reg[reg].value = rob[pos].value;
+			}
+		}
+		else if (opcode == LWS)
+		{
+			unsigned reg = register_index(rob[pos].destination);
+			if (fp_reg[reg].entry == pos)
+			{
+				fp_reg[reg].value = rob[pos].value_f;
+				fp_reg[reg].entry = UNDEFINED;
+			}
+			else if (fp_reg[reg].entry == UNDEFINED || rob[pos].seq < rob[fp_reg[reg].entry].seq)
+			{
+				fp_reg[reg].value = rob[pos].value_f;
+			}
+		}
+		else if (opcode == ADDS || opcode == SUBS || opcode == MULTS || opcode == DIVS)
+		{
+			unsigned reg = register_index(rob[pos].destination);
+			if (fp_reg[reg].entry == pos)
+			{
+				fp_reg[reg].value = rob[pos].value_f;
+				fp_reg[reg].entry = UNDEFINED;
+			}
+			else if (fp_reg[reg].entry == UNDEFINED || rob[pos].seq < rob[fp_reg[reg].entry].seq)
+			{
+				fp_reg[reg].value = rob[pos].value_f;
+			}
+		}
+		else if (opcode == EOP)
+		{
+			eop = true;
+			instruction_count--;
+			clock_cycles--;
+			bool eop_logged = rob[pos].log_index < instruction_log_length;
+			flush_rob();
+			flush_ex();
+			flush_rs();
+			// correction for eop in instruction log
+			if (eop_logged)
+			{
+				instruction_log_length--;
+			}
+			final_pc = rob[pos].pc;
+		}
+		else
+		{
+			unsigned reg = register_index(rob[pos].destination);
+			if (int_reg[reg].entry == pos)
+			{
+				int_reg[reg].value = rob[pos].value;
+				int_reg[reg].entry = UNDEFINED;
+			}
+			else if (int_reg[reg].entry == UNDEFINED || rob[pos].seq < rob[int_reg[reg].entry].seq)
+			{
+				int_reg[reg].value = rob[pos].value;
+			}
+		}
+
+		rob[pos] = clear_rob_entry(pos);
+		retired_entries[retired_count++] = pos;
+		iq[pos].pc = UNDEFINED;
+		iq[pos].Issue = UNDEFINED_CYCLE;
+		iq[pos].Exe = UNDEFINED_CYCLE;
+		iq[pos].WR = UNDEFINED_CYCLE;
+		iq[pos].Commit = UNDEFINED_CYCLE;
+		instruction_count++;
 	}
-	if (i == str.length())
+
+	// what limited retirement this cycle: the commit width, or an instruction at the head still executing
+	if (!eop && rob_count != 0)
 	{
-		index = str.length() + 1;
+		if (!rob[rob_head].ready)
+		{
+			if (committed < commit_max)
+			{
+				commit_head_blocked++;
+			}
+		}
+		else if (committed == commit_max)
+		{
+			commit_width_limited++;
+		}
 	}
-	return index;
 }
 
-int sim_ooo::convert_string_to_number(std::string str)
+int sim_ooo::get_open_rs(reservation_station *rs)
 {
-	int imm = 0;
-	if (str.find('b') < str.length())
+	int station = -1 , size;
+	string name = rs[0].name.substr(0, rs[0].name.length() - 1);
+	if (name == "Int")
 	{
-		str = str.substr(2);
-		imm = strtoul(str.c_str(), NULL, 2);
+		size = size_of_int_rs;
 	}
-	else if ((str.find('x') < str.length()) || (str.find('X') < str.length()))
+	else if (name == "Add")
 	{
-		str = str.substr(2);
-		imm = strtoul(str.c_str(), NULL, 16);
+		size = size_of_add_rs;
 	}
-	else if (str.find('d') < str.length())
+	else if (name == "Mult")
 	{
-		str = str.substr(2);
-		imm = strtoul(str.c_str(), NULL, 10);
+		size = size_of_mult_rs;
+	} 
+	else if (name == "Load")
+	{
+		size = size_of_load_rs;
 	}
 	else
 	{
-		str = str.substr(0);
-		imm = strtoul(str.c_str(), NULL, 10);
+		return station;
 	}
-	return imm;
+	for (int i = 0; i < size; i++)
+	{
+		if (!rs[i].busy && !rs[i].cleared)
+		{
+			station = i;
+			break;
+		}
+	}
+	return station;
 }
 
-void sim_ooo::print_instruction_memory(unsigned start_address, unsigned end_address) {
-	cout << "instruction_memory[0x" << hex << setw(8) << setfill('0') << start_address << ":0x" << hex << setw(8) << setfill('0') << end_address << "]" << endl;
-	unsigned i;
-	for (i = instruction_memory_size; i<instruction_memory_size + 100; i++) {
-		if (i % 1 == 0) cout << "0x" << hex << setw(8) << setfill('0') << i << ": ";
-		cout << hex << setw(2) << setfill('0') << int(instruction_memory[i]) << " ";
-		if (i % 4 == 3) cout << endl;
+int sim_ooo::get_open_rob(read_order_buffer* rob)
+{
+	if (rob_count == size_of_rob) // every entry is in flight
+	{
+		return -1;
+	}
+	if (rob[rob_tail].commit_stall) // entry was retired this cycle and cannot be reused until the next one
+	{
+		if (rob_count != 0)
+		{
+			return -1;
+		}
+		rob_head = rob_tail = (rob_tail + 1) % size_of_rob; // the rob was just flushed so restart after the retired entry
+	}
+	return rob_tail;
+}
+
+void sim_ooo::write_to_rob_issue(unsigned opcode, unsigned open_rob, unsigned pc, unsigned destination, bool int_or_float)
+{
+	if (destination < NUM_GP_REGISTERS && opcode != SW && opcode != SWS) // stores only read the register they name
+	{
+		if (int_or_float)
+		{
+			int_reg[destination].entry = open_rob;
+		}
+		else
+		{
+			fp_reg[destination].entry = open_rob;
+		}
+	}
+	rob[open_rob].pc = pc;
+	rob[open_rob].seq = rob_seq++;
+	rob_tail = (open_rob + 1) % size_of_rob;
+	rob_count++;
+	iq[open_rob].pc = pc;
+	rob[open_rob].log_index = add_il(pc);
+	rob[open_rob].busy = true;
+	rob[open_rob].ready = false;
+	rob[open_rob].opcode = opcode;
+	rob[open_rob].destination = pack_register(destination, int_or_float);
+	rob[open_rob].state = ISSUE;
+	iq[open_rob].Issue = clock_cycles;
+	if (opcode == EOP)
+	{
+		iq[open_rob].pc = UNDEFINED;
+		iq[open_rob].Issue = UNDEFINED_CYCLE;
+	}
+	return;
+}
+
+void sim_ooo::write_to_rs(unsigned open_rs, unsigned rs, unsigned opcode, bool int_or_float, int vj, int vk, float vjf, float vkf, unsigned qj, unsigned qk, unsigned pc, unsigned a, unsigned open_rob)
+{
+	switch (rs)
+	{
+	case 1:
+		int_rs[open_rs].busy = true;
+		int_rs[open_rs].opcode = opcode;
+		if (int_or_float)
+		{
+			int_rs[open_rs].vj = vj;
+			int_rs[open_rs].vk = vk;
+		}
+		else
+		{
+			int_rs[open_rs].vjf = vjf;
+			int_rs[open_rs].vkf = vkf;
+		}
+		int_rs[open_rs].qj = qj;
+		int_rs[open_rs].qk = qk;
+		int_rs[open_rs].dest = open_rob;
+		int_rs[open_rs].a = a;
+		int_rs[open_rs].pc = pc;
+		break;
+	case 2:
+		add_rs[open_rs].busy = true;
+		add_rs[open_rs].opcode = opcode;
+		if (int_or_float)
+		{
+			add_rs[open_rs].vj = vj;
+			add_rs[open_rs].vk = vk;
+		}
+		else
+		{
+			add_rs[open_rs].vjf = vjf;
+			add_rs[open_rs].vkf = vkf;
+		}
+		add_rs[open_rs].qj = qj;
+		add_rs[open_rs].qk = qk;
+		add_rs[open_rs].dest = open_rob;
+		add_rs[open_rs].a = a;
+		add_rs[open_rs].pc = pc;
+		break;
+	case 3:
+		mult_rs[open_rs].busy = true;
+		mult_rs[open_rs].opcode = opcode;
+		if (int_or_float)
+		{
+			mult_rs[open_rs].vj = vj;
+			mult_rs[open_rs].vk = vk;
+		}
+		else
+		{
+			mult_rs[open_rs].vjf = vjf;
+			mult_rs[open_rs].vkf = vkf;
+		}
+		mult_rs[open_rs].qj = qj;
+		mult_rs[open_rs].qk = qk;
+		mult_rs[open_rs].dest = open_rob;
+		mult_rs[open_rs].a = a;
+		mult_rs[open_rs].pc = pc;
+		break;
+	case 4:
+		load_rs[open_rs].busy = true;
+		load_rs[open_rs].opcode = opcode;
+		load_rs[open_rs].vj = vj;
+		load_rs[open_rs].qj = qj;
+		load_rs[open_rs].dest = open_rob;
+		load_rs[open_rs].a = a;
+		load_rs[open_rs].pc = pc;
+		break;
 	}
-}
 
-bool sim_ooo::branchIf(unsigned opcode, unsigned a)
-{
-	bool condition = false;
-	if (opcode == BEQZ && a == 0)
+	unsigned station = open_rs;
+	switch (rs)
 	{
-		condition = true;
+	case 2:
+		station += add_rs - all_rs;
+		break;
+	case 3:
+		station += mult_rs - all_rs;
+		break;
+	case 4:
+		station += load_rs - all_rs;
+		qk = UNDEFINED; // load buffers only wait on their base register
+		break;
 	}
-	else if (opcode == BNEZ && a != 0)
+	switch (rs)
 	{
-		condition = true;
+	case 1:
+		all_rs[station].unit = INTEGER;
+		break;
+	case 2:
+		all_rs[station].unit = ADDER;
+		break;
+	case 3:
+		all_rs[station].unit = (opcode == MULT || opcode == MULTS) ? MULTIPLIER : DIVIDER;
+		break;
+	case 4:
+		all_rs[station].unit = MEMORY;
+		break;
 	}
-	else if (opcode == BLTZ && a < 0)
+	add_waiter(station, qj, false);
+	add_waiter(station, qk, true);
+	if (qj >= size_of_rob && qk >= size_of_rob) // all operands are available at issue
 	{
-		condition = true;
+		set_ready(station);
 	}
-	else if (opcode == BGTZ && a > 0)
+}
+
+void sim_ooo::add_waiter(unsigned station, unsigned tag, bool k)
+{
+	if (tag >= size_of_rob) // operand is not waiting on any rob entry
 	{
-		condition = true;
+		return;
 	}
-	else if (opcode == BLEZ && a <= 0)
+	if (k)
 	{
-		condition = true;
+		all_rs[station].next_k = rob[tag].waiters;
 	}
-	else if (opcode == BGEZ && a >= 0)
+	else
 	{
-		condition = true;
+		all_rs[station].next_j = rob[tag].waiters;
 	}
-	return condition;
+	rob[tag].waiters = station * 2 + (k ? 1 : 0);
 }
 
-void sim_ooo::issue()
+unsigned sim_ooo::get_q(unsigned i, bool int_or_float)
 {
-	for (unsigned i = 0; i < issue_max; i++)
+	if (int_or_float)
 	{
-		bool int_or_float = true;
-		int open_rob = get_open_rob(rob);
-		unsigned destination, pc_entry = pc * 4;
-		if (open_rob == -1) // if no open re-order buffer we stall the issue stage
-		{
-			return;
-		}
-		int opcode = (instruction_memory[pc] >> 26) & 31;
-		if (opcode == LW || opcode == SW || opcode == SWS || opcode == LWS)
-		{
-			int open_rs = get_open_rs(load_rs);
-			if (open_rs == -1) // if no open reservation station we stall the issue stage
-			{
-				return;
-			}
-			destination = ((instruction_memory[pc] >> 21) & 31);
-			unsigned vj = get_int_register(instruction_memory[pc] & 31);
-			float vjf = unsigned2float(UNDEFINED);
-			unsigned vk = UNDEFINED;
-			float vkf = unsigned2float(UNDEFINED);
-			unsigned qj = get_q(instruction_memory[pc] & 31, int_or_float);
-			unsigned qk = UNDEFINED;
-			unsigned a = (instruction_memory[pc] >> 5) & 65535;
-			if (opcode == SWS || opcode == LWS)
-			{
-				int_or_float = false;
-			}
-			write_to_rob_issue(instruction_memory[pc], open_rob, pc_entry, destination, int_or_float); // writes the instruction to the rob
-			write_to_rs(open_rs, 4, opcode, int_or_float, vj, vk, vjf, vkf, qj, qk, pc_entry, a, open_rob);
-		}
-
-		else if (opcode == ADD || opcode == SUB || opcode == XOR || opcode == OR
-			|| opcode == AND || opcode == MULT || opcode == DIV || opcode == ADDS
-			|| opcode == SUBS || opcode == MULTS || opcode == DIVS)
-		{
-			if (opcode == ADDS || opcode == SUBS || opcode == MULTS || opcode == DIVS)
-			{
-				int_or_float = false;
-			}
-			destination = ((instruction_memory[pc] >> 21) & 31);
-			unsigned vj = get_int_register((instruction_memory[pc] >> 16) & 31);
-			float vjf = get_fp_register((instruction_memory[pc] >> 16) & 31);
-			unsigned vk = get_int_register((instruction_memory[pc] >> 11) & 31);
-			float vkf = get_fp_register((instruction_memory[pc] >> 11) & 31);
-			unsigned qj = get_q((instruction_memory[pc] >> 16) & 31, int_or_float);
-			unsigned qk = get_q((instruction_memory[pc] >> 11) & 31, int_or_float);
-			unsigned a = UNDEFINED;
-
-			if (opcode == ADD || opcode == SUB || opcode == XOR || opcode == AND || opcode == OR)
-			{
-				int open_rs = get_open_rs(int_rs);
-				if (open_rs == -1) // if no open reservation station we stall the issue stage
-				{
-					return;
-				}
-				write_to_rs(open_rs, 1, opcode, int_or_float, vj, vk, vjf, vkf, qj, qk, pc_entry, a, open_rob);
-			}
-			else if (opcode == ADDS || opcode == SUBS)
-			{
-				int open_rs = get_open_rs(add_rs);
-				if (open_rs == -1) // if no open reservation station we stall the issue stage
-				{
-					return;
-				}
-				write_to_rs(open_rs, 2, opcode, int_or_float, vj, vk, vjf, vkf, qj, qk, pc_entry, a, open_rob);
-			}
-			else if (opcode == MULT || opcode == MULTS || opcode == DIV || opcode == DIVS)
-			{
-				int open_rs = get_open_rs(mult_rs);
-				if (open_rs == -1) // if no open reservation station we stall the issue stage
-				{
-					return;
-				}
-				write_to_rs(open_rs, 3, opcode, int_or_float, vj, vk, vjf, vkf, qj, qk, pc_entry, a, open_rob);
-			}
-
-			write_to_rob_issue(instruction_memory[pc], open_rob, pc_entry, destination, int_or_float); // writes the instruction to the rob
-		}
-		else if (opcode == ADDI || opcode == SUBI || opcode == XORI
-			|| opcode == ORI || opcode == ANDI)
+		unsigned rob_entry = get_pending_int_register(i);
+		if (rob_entry != UNDEFINED)
 		{
-			destination = ((instruction_memory[pc] >> 21) & 31);
-			unsigned vj = get_int_register((instruction_memory[pc] >> 16) & 31);
-			float vjf = unsigned2float(UNDEFINED);
-			unsigned vk = (instruction_memory[pc] & 65535);
-			float vkf = unsigned2float(UNDEFINED);
-			unsigned qj = get_q((instruction_memory[pc] >> 16) & 31, int_or_float);
-			unsigned qk = UNDEFINED;
-			unsigned a = UNDEFINED;
-			int open_rs = get_open_rs(int_rs);
-			if (open_rs == -1) // if no open reservation station we stall the issue stage
+			if (rob[rob_entry].ready)
 			{
-				return;
+				return UNDEFINED;
 			}
-			write_to_rob_issue(instruction_memory[pc], open_rob, pc_entry, destination, int_or_float); // writes the instruction to the rob
-			write_to_rs(open_rs, 1, opcode, int_or_float, vj, vk, vjf, vkf, qj, qk, pc_entry, a, open_rob);
-		}
-		else if (opcode == BEQZ || opcode == BNEZ || opcode == BLTZ
-			|| opcode == BGTZ || opcode == BLEZ || opcode == BGEZ)
-		{
-			destination = UNDEFINED;
-			unsigned vj = get_int_register((instruction_memory[pc] >> 21) & 31);
-			float vjf = unsigned2float(UNDEFINED);
-			unsigned vk = UNDEFINED;
-			float vkf = unsigned2float(UNDEFINED);
-			unsigned qj = get_q((instruction_memory[pc] >> 21) & 31, int_or_float);
-			unsigned qk = UNDEFINED;
-			unsigned a = (instruction_memory[pc] & 65535) + base_Address;
-			int open_rs = get_open_rs(int_rs);
-			if (open_rs == -1) // if no open reservation station we stall the issue stage
+			else
 			{
-				return;
+				return rob_entry;
 			}
-			write_to_rob_issue(instruction_memory[pc], open_rob, pc_entry, destination, int_or_float); // writes the instruction to the rob
-			write_to_rs(open_rs, 1, opcode, int_or_float, vj, vk, vjf, vkf, qj, qk, pc_entry, a, open_rob);
 		}
-		else if (opcode == JUMP)
+		return UNDEFINED;
+	}
+	else
+	{
+		unsigned rob_entry = get_pending_fp_register(i);
+		if (rob_entry != UNDEFINED)
 		{
-			destination = UNDEFINED;
-			unsigned qj = UNDEFINED;
-			unsigned qk = UNDEFINED;
-			unsigned vj = UNDEFINED;
-			float vjf = unsigned2float(UNDEFINED);
-			unsigned vk = UNDEFINED;
-			float vkf = unsigned2float(UNDEFINED);
-			unsigned a = (instruction_memory[pc] & 65535) + base_Address;
-			int open_rs = get_open_rs(int_rs);
-			if (open_rs == -1) // if no open reservation station we stall the issue stage
+			if (rob[rob_entry].ready)
 			{
-				return;
+				return UNDEFINED;
 			}
-			write_to_rob_issue(instruction_memory[pc], open_rob, pc_entry, destination, int_or_float); // writes the instruction to the rob
-			write_to_rs(open_rs, 1, opcode, int_or_float, vj, vk, vjf, vkf, qj, qk, pc_entry, a, open_rob);
-		}
-		else if (opcode == EOP)
-		{
-			destination = UNDEFINED;
-			unsigned qj = UNDEFINED;
-			unsigned qk = UNDEFINED;
-			unsigned vj = UNDEFINED;
-			float vjf = unsigned2float(UNDEFINED);
-			unsigned vk = UNDEFINED;
-			float vkf = unsigned2float(UNDEFINED);
-			unsigned a = UNDEFINED;
-			int open_rs = get_open_rs(int_rs);
-			if (open_rs == -1) // if no open reservation station we stall the issue stage
+			else
 			{
-				return;
+				return rob_entry;
 			}
-			write_to_rob_issue(instruction_memory[pc], open_rob, pc_entry, destination, int_or_float); // writes the instruction to the rob
-			write_to_rs(open_rs, 1, opcode, int_or_float, vj, vk, vjf, vkf, qj, qk, pc_entry, a, open_rob);
 		}
-		pc++;
+		return UNDEFINED;
 	}
 }
 
-void sim_ooo::execute()
+bool sim_ooo::station_ready(const reservation_station &rs)
 {
-	// check to see if any open exe units
-	int i;
-	bool ex_open;
-	// int unit
-	ex_open = false;
-	int size = size_of_int_ex;
-	for (i = 0; i < size; i++)
+	bool ready = false;
+	if ((rs.qj < 0 || rs.qj > size_of_rob) && (rs.qk < 0 || rs.qk > size_of_rob))
 	{
-		if (!int_ex[i].busy)
+		if (!rs.wb)//checks to see if qj or qk have been written back this cycle
 		{
-			ex_open = true;
-			break; // we have an open ex_unit so end loop
-		} 
+			ready = true;
+		}
 	}
+	return ready;
+}
 
-	// check reservation station to see if the instructions are ready
-	if (ex_open)
+int sim_ooo::compute_result_int(ex_unit ex)
+{
+	int answer = UNDEFINED;
+	unsigned opcode = ex.opcode;
+	switch (opcode)
 	{
-		size = size_of_int_rs;
-		for (int j = 0; j < size; j++)
+	case ADD:
+		answer = ex.vj + ex.vk;
+		break;
+	case SUB:
+		answer = ex.vj - ex.vk;
+		break;
+	case XOR:
+		answer = ex.vj ^ ex.vk;
+		break;
+	case OR:
+		answer = ex.vj | ex.vk;
+		break;
+	case AND:
+		answer = ex.vj & ex.vk;
+		break;
+	case ADDI:
+		answer = ex.vj + ex.vk;
+		break;
+	case SUBI:
+		answer = ex.vj - ex.vk;
+		break;
+	case XORI:
+		answer = ex.vj ^ ex.vk;
+		break;
+	case ORI:
+		answer = ex.vj | ex.vk;
+		break;
+	case ANDI:
+		answer = ex.vj & ex.vk;
+		break;
+	case BEQZ:
+		if (ex.vj == 0)
 		{
-			unsigned rob_entry = int_rs[j].dest;// gets the rob that the instruction is held in
-			if (rob_entry >= 0 && rob_entry <= size_of_rob)
-			{
-				if (rob[rob_entry].state == "ISSUE")
-				{
-
-					if (station_ready(int_rs[j]))//checks if we have all values necessary to compute
-					{
-						//if everything checks out then we move the instruction in the exe unit
-						rob[rob_entry].state = "EXE";
-						iq[rob_entry].Exe = (unsigned)clock_cycles;
-						write_to_il(int_rs[j].pc, 2);
-						if (int_rs[i].opcode == EOP)
-						{
-							iq[rob_entry].Exe = UNDEFINED;
-						}
-						int_ex[i].busy = true;
-						int_ex[i].ttf = int_ex[i].delay;
-						int_ex[i].entry = int_rs[j].dest;
-						int_ex[i].opcode = int_rs[j].opcode;
-						int_ex[i].vj = int_rs[j].vj;
-						if (int_rs[j].opcode == BEQZ || int_rs[j].opcode == BNEZ || int_rs[j].opcode == BLTZ
-							|| int_rs[j].opcode == BGTZ || int_rs[j].opcode == BLEZ || int_rs[j].opcode == BGEZ
-							|| int_rs[j].opcode == JUMP) // if a branch instruction write address to vk for computation
-						{
-							int_ex[i].vk = int_rs[j].a;
-						}
-						else
-						{
-							int_ex[i].vk = int_rs[j].vk;
-						}
-						int_ex[i].vjf = int_rs[j].vjf;
-						int_ex[i].vkf = int_rs[j].vkf;
-						int_ex[i].pc = int_rs[j].pc;
-						break;
-					}
-				}
-			}
+			answer = (ex.vk * 4) + 4;
 		}
-	}
-	//add unit
-	ex_open = false;
-	size = size_of_add_ex;
-	for (i = 0; i < size; i++)
-	{
-		if (!add_ex[i].busy)
+		else
 		{
-			ex_open = true;
-			break; // we have an open ex_unit so end loop
+			answer = ex.pc + 4;
 		}
-	}
-
-	// check reservation station to see if the instructions are ready
-	if (ex_open)
-	{
-		size = size_of_add_rs;
-		for (int j = 0; j < size; j++)
+		break;
+	case BNEZ:
+		if (ex.vj != 0)
 		{
-			unsigned rob_entry = add_rs[j].dest;// gets the rob that the instruction is held in
-			if (rob_entry >= 0 && rob_entry <= size_of_rob)
-			{
-				if (rob[rob_entry].state == "ISSUE")
-				{
-
-					if (station_ready(add_rs[j]))//checks if we have all values necessary to compute
-					{
-						//if everything checks out then we move the instruction in the exe unit
-						rob[rob_entry].state = "EXE";
-						iq[rob_entry].Exe = (unsigned)clock_cycles;
-						write_to_il(add_rs[j].pc, 2);
-						add_ex[i].busy = true;
-						add_ex[i].ttf = add_ex[i].delay;
-						add_ex[i].entry = add_rs[j].dest;
-						add_ex[i].opcode = add_rs[j].opcode;
-						add_ex[i].vj = add_rs[j].vj;
-						add_ex[i].vk = add_rs[j].vk;
-						add_ex[i].vjf = add_rs[j].vjf;
-						add_ex[i].vkf = add_rs[j].vkf;
-						add_ex[i].pc = add_rs[j].pc;
-						break;
-					}
-				}
-			}
+			answer = (ex.vk * 4) + 4;
 		}
-	}
-	//mem unit
-	ex_open = false;
-	size = size_of_mem_ex;
-	for (i = 0; i < size; i++)
-	{
-		if (!mem_ex[i].busy)
+		else
 		{
-			ex_open = true;
-			break; // we have an open ex_unit so end loop
+			answer = ex.pc + 4;
 		}
-	}
-
-	// check reservation station to see if the instructions are ready
-	if (ex_open)
-	{
-		size = size_of_load_rs;
-		for (int j = 0; j < size; j++)
+		break;
+	case BLTZ:
+		if (ex.vj < 0)
 		{
-			unsigned rob_entry = load_rs[j].dest;// gets the rob that the instruction is held in
-			if (rob_entry >= 0 && rob_entry <= size_of_rob)
-			{
-				if (rob[rob_entry].state == "ISSUE")
-				{
-
-					if (station_ready(load_rs[j]))//checks if we have all values necessary to compute
-					{
-						//if everything checks out then we move the instruction in the exe unit
-						rob[rob_entry].state = "EXE";
-						iq[rob_entry].Exe = (unsigned)clock_cycles;
-						write_to_il(load_rs[j].pc, 2);
-						mem_ex[i].busy = true;
-						mem_ex[i].ttf = mem_ex[i].delay;
-						mem_ex[i].entry = load_rs[j].dest;
-						mem_ex[i].opcode = load_rs[j].opcode;
-
-						mem_ex[i].vj = load_rs[j].vj;
-						mem_ex[i].vk = load_rs[j].a;
-						mem_ex[i].pc = load_rs[j].pc;
-						load_rs[j].a = mem_ex[i].vj + mem_ex[i].vk;
-						break;
-					}
-				}
-			}
+			answer = (ex.vk * 4) + 4;
 		}
-	}
-	//mult unit
-	ex_open = false;
-	size = size_of_mult_ex;
-	for (i = 0; i < size; i++)
-	{
-		if (!mult_ex[i].busy)
+		else
 		{
-			ex_open = true;
-			break; // we have an open ex_unit so end loop
+			answer = ex.pc + 4;
 		}
-	}
-
-	// check reservation station to see if the instructions are ready
-	if (ex_open)
-	{
-		size = size_of_mult_rs;
-		for (int j = 0; j < size; j++)
+		break;
+	case BGTZ:
+		if (ex.vj > 0)
 		{
-			unsigned rob_entry = mult_rs[j].dest;// gets the rob that the instruction is held in
-			if (rob_entry >= 0 && rob_entry <= size_of_rob)
-			{
-				if (rob[rob_entry].state == "ISSUE")
-				{
-
-					if (station_ready(mult_rs[j]))//checks if we have all values necessary to compute
-					{
-						if (mult_rs[j].opcode == MULT || mult_rs[j].opcode == MULTS)
-						{
-							//if everything checks out then we move the instruction in the exe unit
-							rob[rob_entry].state = "EXE";
-							iq[rob_entry].Exe = (unsigned)clock_cycles;
-							write_to_il(mult_rs[j].pc, 2);
-							mult_ex[i].busy = true;
-							mult_ex[i].ttf = mult_ex[i].delay;
-							mult_ex[i].entry = mult_rs[j].dest;
-							mult_ex[i].opcode = mult_rs[j].opcode;
-							mult_ex[i].vj = mult_rs[j].vj;
-							mult_ex[i].vk = mult_rs[j].vk;
-							mult_ex[i].vjf = mult_rs[j].vjf;
-							mult_ex[i].vkf = mult_rs[j].vkf;
-							mult_ex[i].pc = mult_rs[j].pc;
-							break;
-						}
-					}
-				}
-			}
+			answer = (ex.vk * 4) + 4;
+		}
+		else
+		{
+			answer = ex.pc + 4;
 		}
-	}
-	//div unit
-	ex_open = false;
-	size = size_of_div_ex;
-	for (i = 0; i < size; i++)
-	{
-		if (!div_ex[i].busy)
+		break;
+	case BLEZ:
+		if (ex.vj <= 0)
 		{
-			ex_open = true;
-			break; // we have an open ex_unit so end loop
+			answer = (ex.vk * 4) + 4;
 		}
-	}
-
-	// check reservation station to see if the instructions are ready
-	if (ex_open)
-	{
-		size = size_of_mult_rs;
-		for (int j = 0; j < size; j++)
+		else
 		{
-			unsigned rob_entry = mult_rs[j].dest;// gets the rob that the instruction is held in
-			if (rob_entry >= 0 && rob_entry <= size_of_rob)
-			{
-				if (rob[rob_entry].state == "ISSUE")
-				{
-
-					if (station_ready(mult_rs[j]))//checks if we have all values necessary to compute
-					{
-						if (mult_rs[j].opcode == DIV || mult_rs[j].opcode == DIVS)
-						{
-							//if everything checks out then we move the instruction in the exe unit
-							rob[rob_entry].state = "EXE";
-							iq[rob_entry].Exe = (unsigned)clock_cycles;
-							write_to_il(mult_rs[j].pc, 2);
-							div_ex[i].busy = true;
-							div_ex[i].ttf = div_ex[i].delay;
-							div_ex[i].entry = mult_rs[j].dest;
-							div_ex[i].opcode = mult_rs[j].opcode;
-							div_ex[i].vj = mult_rs[j].vj;
-							div_ex[i].vk = mult_rs[j].vk;
-							div_ex[i].vjf = mult_rs[j].vjf;
-							div_ex[i].vkf = mult_rs[j].vkf;
-							div_ex[i].pc = mult_rs[j].pc;
-							break;
-						}
-					}
-				}
-			}
+			answer = ex.pc + 4;
 		}
-	}
-
-	// decrement ttf of ex units
-	size = size_of_int_ex;
-	for (i = 0; i < size; i++)
-	{
-		if (int_ex[i].ttf != UNDEFINED)
+		break;
+	case BGEZ:
+		if (ex.vj >= 0)
 		{
-			int_ex[i].ttf--;
+			answer = (ex.vk * 4) + 4;
 		}
-	}
-	size = size_of_add_ex;
-	for (i = 0; i < size; i++)
-	{
-		if (add_ex[i].ttf != UNDEFINED)
+		else
 		{
-			add_ex[i].ttf--;
+			answer = ex.pc + 4;
 		}
+		break;
+	case JUMP:
+		answer = (ex.vk * 4) + 4;
+		break;
+	case MULT:
+		answer = ex.vj * ex.vk;
+		break;
+	case DIV:
+		answer = ex.vj / ex.vk;
+		break;
 	}
-	size = size_of_mem_ex;
-	for (i = 0; i < size; i++)
+	return answer;
+}
+
+float sim_ooo::compute_result_fp(ex_unit ex)
+{
+	float answer = 0;
+	unsigned opcode = ex.opcode;
+	switch (opcode)
 	{
-		if (mem_ex[i].ttf != UNDEFINED)
-		{
-			mem_ex[i].ttf--;
-		}
+	case ADDS:
+		answer = ex.vjf + ex.vkf;
+		break;
+	case SUBS:
+		answer = ex.vjf - ex.vkf;
+		break;
+	case MULTS:
+		answer = ex.vjf * ex.vkf;
+		break;
+	case DIVS:
+		answer = ex.vjf / ex.vkf;
+		break;
 	}
-	size = size_of_mult_ex;
-	for (i = 0; i < size; i++)
+	return answer;
+}
+
+int sim_ooo::compute_address_int(ex_unit ex)
+{
+	int answer = 0;
+	if (ex.opcode == LW)
 	{
-		if (mult_ex[i].ttf != UNDEFINED)
-		{
-			mult_ex[i].ttf--;
-		}
+		answer += data_memory[ex.vj + ex.vk + 3];
+		answer = answer << 8;
+		answer += data_memory[ex.vj + ex.vk + 2];
+		answer = answer << 8;
+		answer += data_memory[ex.vj + ex.vk + 1];
+		answer = answer << 8;
+		answer += data_memory[ex.vj + ex.vk + 0];
 	}
-	size = size_of_div_ex;
-	for (i = 0; i < size; i++)
+	else
 	{
-		if (div_ex[i].ttf != UNDEFINED)
-		{
-			div_ex[i].ttf--;
-		}
+		answer = ex.vj + ex.vk;
 	}
+	return answer;
+}
 
+float sim_ooo::compute_address_fp(ex_unit ex)
+{
+	float ans;
+	int answer = 0;
+	if (ex.opcode == LWS)
+	{
+		answer += data_memory[ex.vj + ex.vk + 3];
+		answer = answer << 8;
+		answer += data_memory[ex.vj + ex.vk + 2];
+		answer = answer << 8;
+		answer += data_memory[ex.vj + ex.vk + 1];
+		answer = answer << 8;
+		answer += data_memory[ex.vj + ex.vk + 0];
+		ans = unsigned2float(answer);
+	}
+	return ans;
 }
 
-void sim_ooo::write_result()
+void sim_ooo::write_rs(int answer, unsigned dest)
 {
-	// check to see if any ex units are done
-	int i;
-	int size = size_of_int_ex;
-	for (i = 0; i < size; i++)
+	// only visit the stations that are waiting on this entry
+	unsigned waiter = rob[dest].waiters;
+	rob[dest].waiters = UNDEFINED;
+	while (waiter != UNDEFINED)
 	{
-		if (int_ex[i].ttf == 0)
+		unsigned waiter_station = waiter / 2;
+		reservation_station &rs = all_rs[waiter_station];
+		if (waiter % 2 == 0)
 		{
-			//clear ex unit after writing result
-			int_ex[i] = clear_ex_unit(int_ex[i].name,int_ex[i].delay);
-		}
-		if (int_ex[i].ttf == 1)
-		{
-			int answer = compute_result_int(int_ex[i]);
-			if (int_ex[i].opcode == BEQZ || int_ex[i].opcode == BNEZ || int_ex[i].opcode == BLTZ || int_ex[i].opcode == BGTZ
-				|| int_ex[i].opcode == BLEZ || int_ex[i].opcode == BGEZ || int_ex[i].opcode == JUMP)
-			{
-				write_rob(answer, int_ex[i].entry);
-			}
-			else
+			waiter = rs.next_j;
+			if (rs.qj == dest)
 			{
-				write_rs(answer, int_ex[i].entry);
-				write_rob(answer, int_ex[i].entry);
+				rs.qj = UNDEFINED;
+				rs.vj = answer;
+				touch_rs(waiter_station);
+				rs.wb = true;
 			}
-			find_and_clear_rs(int_ex[i].pc);
-			write_to_il(int_ex[i].pc, 3);
-		}
-	}
-	size = size_of_add_ex;
-	for (i = 0; i < size; i++)
-	{
-		if (add_ex[i].ttf == 0)
-		{
-			//clear ex unit after writing result
-			add_ex[i] = clear_ex_unit(add_ex[i].name,add_ex[i].delay);
-		}
-		if (add_ex[i].ttf == 1)
-		{
-			float answer = compute_result_fp(add_ex[i]);
-			write_rs(answer, add_ex[i].entry);
-			write_rob(answer, add_ex[i].entry);
-			find_and_clear_rs(add_ex[i].pc);
-			write_to_il(add_ex[i].pc, 3);
-		}
-	}
-	size = size_of_mem_ex;
-	for (i = 0; i < size; i++)
-	{
-		if (mem_ex[i].ttf == 0)
-		{
-			//clear ex unit after writing result
-			mem_ex[i] = clear_ex_unit(mem_ex[i].name,mem_ex[i].delay);
 		}
-		if (mem_ex[i].ttf == 1)
+		else
 		{
-			if (mem_ex[i].opcode == LW || mem_ex[i].opcode == SW || mem_ex[i].opcode == SWS)
+			waiter = rs.next_k;
+			if (rs.qk == dest)
 			{
-				int answer = compute_address_int(mem_ex[i]);
-				if (mem_ex[i].opcode == LW)
-				{
-					write_rs(answer, mem_ex[i].entry);
-				}
-				write_rob(answer, mem_ex[i].entry);
-			}
-			else
-			{
-				float answer = compute_address_fp(mem_ex[i]);
-				write_rs(answer, mem_ex[i].entry);
-				write_rob(answer, mem_ex[i].entry);
+				rs.qk = UNDEFINED;
+				rs.vk = answer;
+				touch_rs(waiter_station);
+				rs.wb = true;
 			}
-			find_and_clear_rs(mem_ex[i].pc);
-			write_to_il(mem_ex[i].pc, 3);
 		}
 	}
-	size = size_of_mult_ex;
-	for (i = 0; i < size; i++)
+}
+
+void sim_ooo::write_rs(float answer, unsigned dest)
+{
+	// only visit the stations that are waiting on this entry
+	unsigned waiter = rob[dest].waiters;
+	rob[dest].waiters = UNDEFINED;
+	while (waiter != UNDEFINED)
 	{
-		if (mult_ex[i].ttf == 0)
+		unsigned waiter_station = waiter / 2;
+		reservation_station &rs = all_rs[waiter_station];
+		if (waiter % 2 == 0)
 		{
-			//clear ex unit after writing result
-			mult_ex[i] = clear_ex_unit(mult_ex[i].name,mult_ex[i].delay);
+			waiter = rs.next_j;
+			if (rs.qj == dest)
+			{
+				rs.qj = UNDEFINED;
+				rs.vjf = answer;
+				touch_rs(waiter_station);
+				rs.wb = true;
+			}
 		}
-		if (mult_ex[i].ttf == 1)
+		else
 		{
-			float answer = compute_result_fp(mult_ex[i]);
-			write_rs(answer, mult_ex[i].entry);
-			write_rob(answer, mult_ex[i].entry);
-			find_and_clear_rs(mult_ex[i].pc);
-			write_to_il(mult_ex[i].pc, 3);
+			waiter = rs.next_k;
+			if (rs.qk == dest)
+			{
+				rs.qk = UNDEFINED;
+				rs.vkf = answer;
+				touch_rs(waiter_station);
+				rs.wb = true;
+			}
 		}
 	}
-	size = size_of_div_ex;
-	for (i = 0; i < size; i++)
+}
+
+void sim_ooo::write_rob(int answer, unsigned entry)
+{
+	rob[entry].value = answer;
+	rob[entry].state = WRITE_RESULT;
+	iq[entry].WR = clock_cycles;
+	if (rob[entry].opcode == EOP)
 	{
-		if (div_ex[i].ttf == 0)
-		{
-			//clear ex unit after writing result
-			div_ex[i] = clear_ex_unit(div_ex[i].name,div_ex[i].delay);
-		}
-		if (div_ex[i].ttf == 1)
-		{
-			float answer = compute_result_fp(div_ex[i]);
-			write_rs(answer, div_ex[i].entry);
-			write_rob(answer, div_ex[i].entry);
-			find_and_clear_rs(div_ex[i].pc);
-			write_to_il(div_ex[i].pc, 3);
-		}
+		iq[entry].WR = UNDEFINED_CYCLE;
 	}
+	rob[entry].ready = true;
 }
 
-void sim_ooo::commit()
+void sim_ooo::write_rob(float answer, unsigned entry)
 {
-	//find the lowest entry
-	clear_write_back_check();
-	clear_commit_stall();
-	for (int i = 0; i < 1; i++)//appears to be multi issue, but single commit
+	rob[entry].value = float2unsigned(answer);
+	rob[entry].value_f = answer;
+	rob[entry].state = WRITE_RESULT;
+	iq[entry].WR = clock_cycles;
+	rob[entry].ready = true;
+}
+
+ex_unit sim_ooo::clear_ex_unit(std::string name, unsigned delay, unsigned type)
+{
+	ex_unit ex;
+	ex.name = name;
+	ex.busy = false;
+	ex.entry = UNDEFINED;
+	ex.opcode = UNDEFINED;
+	ex.finish = UNDEFINED;
+	ex.next = NULL;
+	ex.type = type;
+	ex.delay = delay;
+	ex.vj = UNDEFINED;
+	ex.vk = UNDEFINED;
+	ex.vjf = (float)UNDEFINED;
+	ex.vkf = (float)UNDEFINED;
+	ex.pc = UNDEFINED;
+	return ex;
+}
+
+void sim_ooo::flush_rob()
+{
+	if (front != NULL) // issue restarts on the correct path
 	{
-		unsigned entry = rob[0].pc;
-		unsigned pos = 0;
-		int size = size_of_rob;
-		for (int i = 0; i < size; i++)
-		{
-			if (rob[i].pc < entry)
-			{
-				entry = rob[i].pc;
-				pos = i;
-			}
-		}
-		if (rob[pos].ready)
-		{
-			write_to_il(rob[pos].pc, 4);
-			unsigned opcode = (rob[pos].instruction >> 26) & 31;
-			if (opcode == BEQZ || opcode == BNEZ || opcode == BLTZ
-				|| opcode == BGTZ || opcode == BLEZ || opcode == BGEZ)
-			{
-				if (rob[pos].value != (rob[pos].pc + 4)) // branch was taken
-				{
-					pc = (rob[pos].value - 4) / 4;
-					flush_rob();
-					flush_ex();
-					flush_rs();
-					/*
-					if ((instruction_memory[pc] >> 26) == (UNDEFINED & 31)) // if we clear everything and the pc now points to a null instruction
-					{
-						eop = true;
-						flush_rob();
-						flush_ex();
-						flush_rs();
-						final_pc = rob[pos].pc;
-					}
-					*/
-				}
-			}
-			else if (opcode == JUMP)
-			{
-				pc = (rob[pos].value - 4) / 4;
-			}
-			else if (opcode == SW)
-			{
-				int reg = get_register_value(rob[pos].destination);
-				write_memory(rob[pos].value, int_reg[reg].value);
-			}
-			else if (opcode == SWS)
-			{
-				int reg = get_register_value(rob[pos].destination);
-				write_memory(rob[pos].value, float2unsigned(fp_reg[reg].value));
-			}
-			else if (opcode == LW)
-			{
-				int reg = get_register_value(rob[pos].destination);
-				if (int_reg[reg].entry == pos)
-				{
-					int_reg[reg].value = rob[pos].value;
-					int_reg[reg].entry = UNDEFINED;
-				}
-				else if ((rob[pos].pc < rob[fp_reg[reg].entry].pc))
-				{
-					int_reg[reg].value = rob[pos].value;
-				}
-			}
-			else if (opcode == LWS)
-			{
-				int reg = get_register_value(rob[pos].destination);
-				if (fp_reg[reg].entry == pos)
-				{
-					fp_reg[reg].value = rob[pos].value_f;
-					fp_reg[reg].entry = UNDEFINED;
-				}
-				else if ((rob[pos].pc < rob[fp_reg[reg].entry].pc))
-				{
-					fp_reg[reg].value = rob[pos].value_f;
-				}
-			}
-			else if (opcode == ADDS || opcode == SUBS || opcode == MULTS || opcode == DIVS)
-			{
-				int reg = get_register_value(rob[pos].destination);
-				if (fp_reg[reg].entry == pos)
-				{
-					fp_reg[reg].value = rob[pos].value_f;
-					fp_reg[reg].entry = UNDEFINED;
-				}
-				else if ((rob[pos].pc < rob[fp_reg[reg].entry].pc))
-				{
-					fp_reg[reg].value = rob[pos].value_f;
-				}
-			}
-			else if (opcode == EOP)
-			{
-				eop = true;
-				instruction_count--;
-				clock_cycles--;
-				flush_rob();
-				flush_ex();
-				flush_rs();
-				// correction for eop in instruction log
-				instruction_log_length--;
-				instruction_q* new_log = new instruction_q[instruction_log_length]; // make new instruction log that is one longer
-				for (unsigned i = 0; i < instruction_log_length; i++) // copy the old log over to the new one
-				{
-					new_log[i] = il[i];
-				}
-				il = new_log;
-				final_pc = rob[pos].pc;
-			}
-			else
-			{
-				int reg = get_register_value(rob[pos].destination);
-				if (int_reg[reg].entry == pos)
-				{
-					int_reg[reg].value = rob[pos].value;
-					int_reg[reg].entry = UNDEFINED;
-				}
-				else if ((rob[pos].pc < rob[fp_reg[reg].entry].pc))
-				{
-					int_reg[reg].value = rob[pos].value;
-				}
-			}
+		front->wrong_path = false;
+	}
+	if (predictor != NULL) // and so does the history of the branches in flight
+	{
+		predictor->history = predictor->retired_history;
+	}
+	rob_head = 0;
+	rob_tail = 0;
+	rob_count = 0;
+	retired_count = 0;
+	checkpoints_in_use = 0;
+	for (unsigned i = 0; i < NUM_GP_REGISTERS; i++) // nothing in flight renames a register any more
+	{
+		int_reg[i].entry = UNDEFINED;
+		fp_reg[i].entry = UNDEFINED;
+	}
+	int size = size_of_rob;
+	for (int i = 0; i < size; i++)
+	{
+		rob[i].entry = 1+i;
+		rob[i].busy = false;
+		rob[i].destination = UNDEFINED;
+		rob[i].pc = UNDEFINED;
+		rob[i].opcode = UNDEFINED;
+		rob[i].ready = false;
+		rob[i].state = NO_STAGE;
+		rob[i].value = UNDEFINED;
+		rob[i].value_f = (float)UNDEFINED;
+		rob[i].log_index = UNDEFINED_LOG;
+		rob[i].seq = UNDEFINED_SEQ;
+		rob[i].waiters = UNDEFINED;
+		rob[i].commit_stall = false;
+		rob[i].traced = false;
+		rob[i].predicted_taken = false;
+		rob[i].btb_miss = false;
+		rob[i].history = 0;
+		rob[i].mispredicted = false;
+		rob[i].checkpointed = false;
+		rob[i].data_entry = UNDEFINED;
+		rob[i].delayed = false;
 
-			rob[pos] = clear_rob_entry(pos);
-			iq[pos].pc = UNDEFINED;
-			iq[pos].Issue = UNDEFINED;
-			iq[pos].Exe = UNDEFINED;
-			iq[pos].WR = UNDEFINED;
-			iq[pos].Commit = UNDEFINED;
-			instruction_count++;
-		}
+		iq[i].pc = UNDEFINED;
+		iq[i].Issue = UNDEFINED_CYCLE;
+		iq[i].Exe = UNDEFINED_CYCLE;
+		iq[i].WR = UNDEFINED_CYCLE;
+		iq[i].Commit = UNDEFINED_CYCLE;
 	}
 }
 
-int sim_ooo::get_open_rs(reservation_station *rs)
+read_order_buffer sim_ooo::clear_rob_entry(unsigned entry)
 {
-	int station = -1 , size;
-	string name = rs[0].name.substr(0, rs[0].name.length() - 1);
-	if (name == "Int")
+	read_order_buffer empty;
+	empty.entry = entry;
+	empty.busy = false;
+	empty.destination = UNDEFINED;
+	empty.pc = UNDEFINED;
+	empty.opcode = UNDEFINED;
+	empty.ready = false;
+	empty.state = NO_STAGE;
+	empty.value = UNDEFINED;
+	empty.value_f = (float)UNDEFINED;
+	empty.log_index = UNDEFINED_LOG;
+	empty.seq = UNDEFINED_SEQ;
+	empty.waiters = rob[entry].waiters; // stations still waiting on this tag are woken by its next producer
+	empty.commit_stall = true;
+	empty.traced = false;
+	empty.predicted_taken = false;
+	empty.btb_miss = false;
+	empty.history = 0;
+	empty.mispredicted = false;
+	empty.checkpointed = false;
+	empty.data_entry = UNDEFINED;
+	empty.delayed = false;
+	return empty;
+}
+
+void sim_ooo::flush_ex()
+{
+	for (unsigned i = 0; i < wheel_size; i++)
 	{
-		size = size_of_int_rs;
+		wheel[i] = NULL;
 	}
-	else if (name == "Add")
+	releasing = NULL;
+
+	int size = size_of_int_ex;
+	for (int i = 0; i < size; i++)
 	{
-		size = size_of_add_rs;
+		int_ex[i] = clear_ex_unit(int_ex[i].name, int_ex[i].delay, int_ex[i].type);
 	}
-	else if (name == "Mult")
+	size = size_of_add_ex;
+	for (int i = 0; i < size; i++)
 	{
-		size = size_of_mult_rs;
-	} 
-	else if (name == "Load")
+		add_ex[i] = clear_ex_unit(add_ex[i].name, add_ex[i].delay, add_ex[i].type);
+	}
+	size = size_of_mult_ex;
+	for (int i = 0; i < size; i++)
 	{
-		size = size_of_load_rs;
+		mult_ex[i] = clear_ex_unit(mult_ex[i].name, mult_ex[i].delay, mult_ex[i].type);
 	}
-	else
+	size = size_of_div_ex;
+	for (int i = 0; i < size; i++)
 	{
-		return station;
+		div_ex[i] = clear_ex_unit(div_ex[i].name, div_ex[i].delay, div_ex[i].type);
 	}
+	size = size_of_mem_ex;
 	for (int i = 0; i < size; i++)
 	{
-		if (!rs[i].busy && !rs[i].cleared)
-		{
-			station = i;
-			break;
-		}
+		mem_ex[i] = clear_ex_unit(mem_ex[i].name, mem_ex[i].delay, mem_ex[i].type);
 	}
-	return station;
 }
 
-int sim_ooo::get_open_rob(read_order_buffer* rob)
+void sim_ooo::flush_rs()
 {
-	int station = -1;
-	int size = size_of_rob;
-
-	for (int i = open_rob_entry; i < size; i++)
+	// every station is cleared, so every station has flags to reset next cycle
+	unsigned total = size_of_int_rs + size_of_add_rs + size_of_mult_rs + size_of_load_rs;
+	for (unsigned i = 0; i < total; i++)
 	{
-		if (!rob[i].busy)
-		{
-			if (!rob[i].commit_stall)
-			{
-				station = i;
-				open_rob_entry = station;
-				return station;
-			}			
-		}
+		touched_rs[i] = i;
 	}
-	for (unsigned i = 0; i < open_rob_entry; i++)
+	touched_count = total;
+	for (unsigned i = 0; i < NUM_EXE_UNITS * ready_words; i++)
 	{
-		if (!rob[i].busy)
-		{
-			if (!rob[i].commit_stall)
-			{
-				station = i;
-				open_rob_entry = station;
-				return station;
-			}
-		}
+		ready_rs[i] = 0;
 	}
-	return station;
-}
 
-void sim_ooo::write_to_rob_issue(unsigned instruction, unsigned open_rob, unsigned pc, unsigned destination, bool int_or_float)
-{
-	string des;
-	if (int_or_float)
+	int size = size_of_int_rs;
+	for (int i = 0; i < size; i++)
 	{
-		des = "R";
-		int_reg[destination].entry = open_rob;
+		int_rs[i] = clear_rs(int_rs[i].name);
 	}
-	else
+	size = size_of_add_rs;
+	for (int i = 0; i < size; i++)
 	{
-		des = "F";
-		fp_reg[destination].entry = open_rob;
+		add_rs[i] = clear_rs(add_rs[i].name);
 	}
-	rob[open_rob].pc = pc;
-	iq[open_rob].pc = pc;
-	add_il(pc);
-	rob[open_rob].busy = true;
-	rob[open_rob].ready = false;
-	rob[open_rob].instruction = instruction;
-	rob[open_rob].destination = des + to_string(destination);
-	rob[open_rob].state = "ISSUE";
-	iq[open_rob].Issue = (unsigned)clock_cycles;
-	write_to_il(pc, 1);
-	if ((instruction >> 26) == EOP)
+	size = size_of_mult_rs;
+	for (int i = 0; i < size; i++)
 	{
-		iq[open_rob].pc = UNDEFINED;
-		iq[open_rob].Issue = UNDEFINED;
+		mult_rs[i] = clear_rs(mult_rs[i].name);
 	}
-	return;
-}
-
-void sim_ooo::write_to_rs(unsigned open_rs, unsigned rs, unsigned opcode, bool int_or_float, int vj, int vk, float vjf, float vkf, unsigned qj, unsigned qk, unsigned pc, unsigned a, unsigned open_rob)
-{
-	switch (rs)
+	size = size_of_load_rs;
+	for (int i = 0; i < size; i++)
 	{
-	case 1:
-		int_rs[open_rs].busy = true;
-		int_rs[open_rs].opcode = opcode;
-		if (int_or_float)
-		{
-			int_rs[open_rs].vj = vj;
-			int_rs[open_rs].vk = vk;
-		}
-		else
-		{
-			int_rs[open_rs].vjf = vjf;
-			int_rs[open_rs].vkf = vkf;
-		}
-		int_rs[open_rs].qj = qj;
-		int_rs[open_rs].qk = qk;
-		int_rs[open_rs].dest = open_rob;
-		int_rs[open_rs].a = a;
-		int_rs[open_rs].pc = pc;
-		break;
-	case 2:
-		add_rs[open_rs].busy = true;
-		add_rs[open_rs].opcode = opcode;
-		if (int_or_float)
-		{
-			add_rs[open_rs].vj = vj;
-			add_rs[open_rs].vk = vk;
-		}
-		else
-		{
-			add_rs[open_rs].vjf = vjf;
-			add_rs[open_rs].vkf = vkf;
-		}
-		add_rs[open_rs].qj = qj;
-		add_rs[open_rs].qk = qk;
-		add_rs[open_rs].dest = open_rob;
-		add_rs[open_rs].a = a;
-		add_rs[open_rs].pc = pc;
-		break;
-	case 3:
-		mult_rs[open_rs].busy = true;
-		mult_rs[open_rs].opcode = opcode;
-		if (int_or_float)
-		{
-			mult_rs[open_rs].vj = vj;
-			mult_rs[open_rs].vk = vk;
-		}
-		else
-		{
-			mult_rs[open_rs].vjf = vjf;
-			mult_rs[open_rs].vkf = vkf;
-		}
-		mult_rs[open_rs].qj = qj;
-		mult_rs[open_rs].qk = qk;
-		mult_rs[open_rs].dest = open_rob;
-		mult_rs[open_rs].a = a;
-		mult_rs[open_rs].pc = pc;
-		break;
-	case 4:
-		load_rs[open_rs].busy = true;
-		load_rs[open_rs].opcode = opcode;
-		load_rs[open_rs].vj = vj;
-		load_rs[open_rs].qj = qj;
-		load_rs[open_rs].dest = open_rob;
-		load_rs[open_rs].a = a;
-		load_rs[open_rs].pc = pc;
-		break;
+		load_rs[i] = clear_rs(load_rs[i].name);
 	}
 }
 
-unsigned sim_ooo::get_q(unsigned i, bool int_or_float)
+reservation_station sim_ooo::clear_rs(std::string name)
 {
-	if (int_or_float)
-	{
-		unsigned rob_entry = get_pending_int_register(i);
-		if (rob_entry != UNDEFINED)
-		{
-			if (rob[rob_entry].ready)
-			{
-				return UNDEFINED;
-			}
-			else
-			{
-				return rob_entry;
-			}
-		}
-		return UNDEFINED;
-	}
-	else
-	{
-		unsigned rob_entry = get_pending_fp_register(i);
-		if (rob_entry != UNDEFINED)
-		{
-			if (rob[rob_entry].ready)
-			{
-				return UNDEFINED;
-			}
-			else
-			{
-				return rob_entry;
-			}
-		}
-		return UNDEFINED;
-	}
+	reservation_station rs;
+	rs.name = name;
+	rs.a = UNDEFINED;
+	rs.pc = UNDEFINED;
+	rs.busy = false;
+	rs.dest = UNDEFINED;
+	rs.opcode = UNDEFINED;
+	rs.qj = UNDEFINED;
+	rs.qk = UNDEFINED;
+	rs.vj = UNDEFINED;
+	rs.vk = UNDEFINED;
+	rs.vjf = unsigned2float(UNDEFINED);
+	rs.vkf = unsigned2float(UNDEFINED);
+	rs.next_j = UNDEFINED;
+	rs.next_k = UNDEFINED;
+	rs.unit = 0;
+	rs.wb = false;
+	rs.cleared = true;
+	return rs;
 }
 
-bool sim_ooo::station_ready(reservation_station rs)
+void sim_ooo::find_and_clear_rs(unsigned entry)
 {
-	bool ready = false;
-	if ((rs.qj < 0 || rs.qj > size_of_rob) && (rs.qk < 0 || rs.qk > size_of_rob))
+	int size = size_of_int_rs;
+	for (int i = 0; i < size; i++)
 	{
-		if (!rs.wb)//checks to see if qj or qk have been written back this cycle
+		if (int_rs[i].busy && int_rs[i].dest == entry)
 		{
-			ready = true;
+			unsigned station = &int_rs[i] - all_rs;
+			clear_ready(station);
+			touch_rs(station);
+			int_rs[i] = clear_rs(int_rs[i].name);
+			return;
 		}
 	}
-	return ready;
-}
-
-int sim_ooo::compute_result_int(ex_unit ex)
-{
-	int answer = UNDEFINED;
-	unsigned opcode = ex.opcode;
-	switch (opcode)
+	size = size_of_add_rs;
+	for (int i = 0; i < size; i++)
 	{
-	case ADD:
-		answer = ex.vj + ex.vk;
-		break;
-	case SUB:
-		answer = ex.vj - ex.vk;
-		break;
-	case XOR:
-		answer = ex.vj ^ ex.vk;
-		break;
-	case OR:
-		answer = ex.vj | ex.vk;
-		break;
-	case AND:
-		answer = ex.vj & ex.vk;
-		break;
-	case ADDI:
-		answer = ex.vj + ex.vk;
-		break;
-	case SUBI:
-		answer = ex.vj - ex.vk;
-		break;
-	case XORI:
-		answer = ex.vj ^ ex.vk;
-		break;
-	case ORI:
-		answer = ex.vj | ex.vk;
-		break;
-	case ANDI:
-		answer = ex.vj & ex.vk;
-		break;
-	case BEQZ:
-		if (ex.vj == 0)
+		if (add_rs[i].busy && add_rs[i].dest == entry)
 		{
-			answer = (ex.vk * 4) + 4;
+			unsigned station = &add_rs[i] - all_rs;
+			clear_ready(station);
+			touch_rs(station);
+			add_rs[i] = clear_rs(add_rs[i].name);
+			return;
 		}
-		else
+	}
+	size = size_of_mult_rs;
+	for (int i = 0; i < size; i++)
+	{
+		if (mult_rs[i].busy && mult_rs[i].dest == entry)
 		{
-			answer = ex.pc + 4;
+			unsigned station = &mult_rs[i] - all_rs;
+			clear_ready(station);
+			touch_rs(station);
+			mult_rs[i] = clear_rs(mult_rs[i].name);
+			return;
 		}
-		break;
-	case BNEZ:
-		if (ex.vj != 0)
+	}
+	size = size_of_load_rs;
+	for (int i = 0; i < size; i++)
+	{
+		if (load_rs[i].busy && load_rs[i].dest == entry)
 		{
-			answer = (ex.vk * 4) + 4;
+			unsigned station = &load_rs[i] - all_rs;
+			clear_ready(station);
+			touch_rs(station);
+			load_rs[i] = clear_rs(load_rs[i].name);
+			return;
 		}
-		else
+	}
+}
+
+void sim_ooo::clear_write_back_check()
+{
+	// only stations woken or freed last cycle have flags to clear
+	for (unsigned i = 0; i < touched_count; i++)
+	{
+		reservation_station &rs = all_rs[touched_rs[i]];
+		rs.wb = false;
+		rs.cleared = false;
+		if (rs.busy && rs.dest < size_of_rob && rob[rs.dest].state == ISSUE && station_ready(rs))
 		{
-			answer = ex.pc + 4;
+			set_ready(touched_rs[i]);
 		}
-		break;
-	case BLTZ:
-		if (ex.vj < 0)
+	}
+	touched_count = 0;
+}
+
+void sim_ooo::clear_commit_stall()
+{
+	for (unsigned i = 0; i < retired_count; i++)
+	{
+		rob[retired_entries[i]].commit_stall = false;
+	}
+	retired_count = 0;
+}
+
+unsigned long long sim_ooo::add_il(unsigned pc)
+{
+	if (instruction_log_length >= instruction_log_limit) // log is off or has reached its limit
+	{
+		return UNDEFINED_LOG;
+	}
+	if (instruction_log_length == instruction_log_capacity) // log is full so double its capacity
+	{
+		unsigned long long new_capacity = instruction_log_capacity == 0 ? 64 : instruction_log_capacity * 2;
+		if (new_capacity > instruction_log_limit)
 		{
-			answer = (ex.vk * 4) + 4;
+			new_capacity = instruction_log_limit;
 		}
-		else
+		instruction_q* new_log = new instruction_q[new_capacity];
+		if (il != NULL)
 		{
-			answer = ex.pc + 4;
+			memcpy(new_log, il, instruction_log_length * sizeof(instruction_q));
 		}
+		delete[] il;
+		il = new_log;
+		instruction_log_capacity = new_capacity;
+	}
+
+	unsigned long long index = instruction_log_length;
+	il[index].pc = pc;
+	il[index].Issue = clock_cycles;
+	il[index].Exe = UNDEFINED_CYCLE;
+	il[index].WR = UNDEFINED_CYCLE;
+	il[index].Commit = UNDEFINED_CYCLE;
+	instruction_log_length++;
+	return index;
+}
+
+void sim_ooo::write_to_il(unsigned long long index, unsigned stage)
+{
+	if (index >= instruction_log_length) // entry was never logged or has been dropped
+	{
+		return;
+	}
+	switch (stage)
+	{
+	case 1:
+		il[index].Issue = clock_cycles;
 		break;
-	case BGTZ:
-		if (ex.vj > 0)
+	case 2:
+		il[index].Exe = clock_cycles;
+		break;
+	case 3:
+		il[index].WR = clock_cycles;
+		break;
+	case 4:
+		il[index].Commit = clock_cycles;
+		break;
+	}
+}
+
+unsigned sim_ooo::ex_unit_id(ex_unit *ex)
+{
+	if (ex == NULL)
+	{
+		return UNDEFINED;
+	}
+	ex_unit *units[NUM_EXE_UNITS] = {int_ex, add_ex, mult_ex, div_ex, mem_ex};
+	unsigned sizes[NUM_EXE_UNITS] = {size_of_int_ex, size_of_add_ex, size_of_mult_ex, size_of_div_ex, size_of_mem_ex};
+	unsigned base = 0;
+	for (unsigned u = 0; u < NUM_EXE_UNITS; u++)
+	{
+		if (ex >= units[u] && ex < units[u] + sizes[u])
 		{
-			answer = (ex.vk * 4) + 4;
+			return base + (ex - units[u]);
 		}
-		else
+		base += sizes[u];
+	}
+	return UNDEFINED;
+}
+
+ex_unit *sim_ooo::ex_unit_from_id(unsigned id)
+{
+	ex_unit *units[NUM_EXE_UNITS] = {int_ex, add_ex, mult_ex, div_ex, mem_ex};
+	unsigned sizes[NUM_EXE_UNITS] = {size_of_int_ex, size_of_add_ex, size_of_mult_ex, size_of_div_ex, size_of_mem_ex};
+	for (unsigned u = 0; u < NUM_EXE_UNITS; u++)
+	{
+		if (id < sizes[u])
 		{
-			answer = ex.pc + 4;
+			return &units[u][id];
 		}
-		break;
-	case BLEZ:
-		if (ex.vj <= 0)
+		id -= sizes[u];
+	}
+	return NULL;
+}
+
+bool sim_ooo::save_checkpoint(const char *filename)
+{
+	if (front != NULL)
+	{
+		return false;
+	}
+	ofstream out(filename, ios::out | ios::binary | ios::trunc);
+	if (!out.is_open() || !save_checkpoint(out))
+	{
+		return false;
+	}
+	out.close();
+	return !out.fail();
+}
+
+bool sim_ooo::save_checkpoint(ostream &out)
+{
+	if (front != NULL) // the functional thread's state is not saved
+	{
+		return false;
+	}
+	out.write(checkpoint_magic, sizeof(checkpoint_magic));
+	write_u32(out, CHECKPOINT_VERSION);
+
+	//configuration
+	write_u32(out, data_memory_size);
+	write_u32(out, size_of_rob);
+	write_u32(out, size_of_int_rs);
+	write_u32(out, size_of_add_rs);
+	write_u32(out, size_of_mult_rs);
+	write_u32(out, size_of_load_rs);
+	write_u32(out, issue_max);
+	write_u32(out, commit_max);
+	unsigned ex_sizes[NUM_EXE_UNITS] = {size_of_int_ex, size_of_add_ex, size_of_mult_ex, size_of_div_ex, size_of_mem_ex};
+	for (unsigned u = 0; u < NUM_EXE_UNITS; u++)
+	{
+		write_u32(out, ex_sizes[u]);
+	}
+	write_u32(out, wheel_size);
+
+	//program
+	write_u32(out, base_Address);
+	write_u32(out, instruction_memory_size);
+	write_u32(out, decoded_memory_size);
+	for (unsigned i = 0; i < decoded_memory_size; i++)
+	{
+		write_u32(out, instruction_memory[i]);
+	}
+
+	//data memory, one chunk at a time
+	unsigned chunks = (data_memory_size + CHECKPOINT_CHUNK - 1) / CHECKPOINT_CHUNK;
+	for (unsigned c = 0; c < chunks; c++)
+	{
+		unsigned start = c * CHECKPOINT_CHUNK;
+		unsigned length = data_memory_size - start < CHECKPOINT_CHUNK ? data_memory_size - start : CHECKPOINT_CHUNK;
+		unsigned i;
+		for (i = 0; i < length && data_memory[start + i] == 0xFF; i++);
+		if (i < length)
 		{
-			answer = (ex.vk * 4) + 4;
+			write_u32(out, c);
+			out.write((const char *)data_memory + start, length);
 		}
-		else
+	}
+	write_u32(out, UNDEFINED);
+
+	//counters and control state
+	write_u32(out, pc);
+	write_u64(out, clock_cycles);
+	write_u64(out, instruction_count);
+	write_u64(out, stalls);
+	write_u64(out, commit_width_limited);
+	write_u64(out, commit_head_blocked);
+	write_u64(out, forwarded_loads);
+	write_u64(out, memory_conflicts);
+	write_u32(out, sample_count);
+	write_u64(out, float2unsigned_double(sample_cpi_sum));
+	write_u64(out, float2unsigned_double(sample_cpi_square_sum));
+	write_u32(out, eop);
+	write_u32(out, stalled);
+	write_u32(out, final_pc);
+
+	//loop extrapolation
+	write_u32(out, loop_extrapolation);
+	write_u32(out, loop_body_length);
+	for (unsigned i = 0; loop_body_length != UNDEFINED && i < loop_body_length; i++)
+	{
+		write_u32(out, loop_body[i]);
+	}
+	write_u32(out, loop_last_length);
+	for (unsigned i = 0; loop_last_length != UNDEFINED && i < loop_last_length; i++)
+	{
+		write_u32(out, loop_last_body[i]);
+	}
+	write_u64(out, loop_fingerprint);
+	write_u64(out, loop_edge_cycles);
+	write_u64(out, loop_edge_stalls);
+	write_u64(out, loop_delta_cycles);
+	write_u64(out, loop_delta_stalls);
+	write_u64(out, loop_edge_limited);
+	write_u64(out, loop_edge_blocked);
+	write_u64(out, loop_delta_limited);
+	write_u64(out, loop_delta_blocked);
+	write_u64(out, loop_edge_branches);
+	write_u64(out, loop_edge_mispredictions);
+	write_u64(out, loop_edge_btb_misses);
+	write_u64(out, loop_edge_updates);
+	write_u64(out, loop_delta_branches);
+	write_u64(out, loop_delta_mispredictions);
+	write_u64(out, loop_delta_btb_misses);
+	write_u64(out, loop_edge_checkpoint_stalls);
+	write_u64(out, loop_delta_checkpoint_stalls);
+	write_u64(out, loop_edge_forwarded);
+	write_u64(out, loop_edge_conflicts);
+	write_u64(out, loop_delta_forwarded);
+	write_u64(out, loop_delta_conflicts);
+	write_u64(out, extrapolations);
+	write_u64(out, extrapolated_iterations);
+	write_u64(out, extrapolated_instructions);
+	write_u64(out, extrapolated_cycles);
+
+	//branch prediction
+	write_u64(out, branches);
+	write_u64(out, mispredictions);
+	write_u64(out, btb_misses);
+	write_u32(out, early_resolution);
+	write_u32(out, rename_checkpoints);
+	write_u32(out, checkpoints_in_use);
+	write_u64(out, checkpoint_stalls);
+	write_u32(out, predictor != NULL ? predictor->kind : PREDICT_NOT_TAKEN);
+	if (predictor != NULL)
+	{
+		write_u32(out, predictor->index_bits);
+		write_u32(out, predictor->btb_size);
+		out.write((const char *)predictor->counters, 1u << predictor->index_bits);
+		for (unsigned i = 0; predictor->tagged != NULL && i < ((unsigned)TAGE_TABLES << predictor->index_bits); i++)
 		{
-			answer = ex.pc + 4;
+			const tage_entry &entry = predictor->tagged[i];
+			write_u32(out, entry.tag | ((unsigned char)entry.counter << 16) | (entry.useful << 24));
 		}
-		break;
-	case BGEZ:
-		if (ex.vj >= 0)
+		for (unsigned i = 0; i < predictor->btb_size; i++)
 		{
-			answer = (ex.vk * 4) + 4;
+			write_u32(out, predictor->btb_pc[i]);
+			write_u32(out, predictor->btb_target[i]);
 		}
-		else
+		write_u64(out, predictor->history);
+		write_u64(out, predictor->retired_history);
+		write_u64(out, predictor->updates);
+	}
+
+	//registers
+	for (unsigned i = 0; i < NUM_GP_REGISTERS; i++)
+	{
+		write_u32(out, int_reg[i].value);
+		write_u32(out, int_reg[i].entry);
+		write_u32(out, float2unsigned(fp_reg[i].value));
+		write_u32(out, fp_reg[i].entry);
+	}
+
+	//reservation stations
+	unsigned total_rs = size_of_int_rs + size_of_add_rs + size_of_mult_rs + size_of_load_rs;
+	for (unsigned i = 0; i < total_rs; i++)
+	{
+		reservation_station &rs = all_rs[i];
+		write_u32(out, rs.busy | (rs.wb << 1) | (rs.cleared << 2));
+		write_u32(out, rs.opcode);
+		write_u32(out, rs.vj);
+		write_u32(out, rs.vk);
+		write_u32(out, float2unsigned(rs.vjf));
+		write_u32(out, float2unsigned(rs.vkf));
+		write_u32(out, rs.qj);
+		write_u32(out, rs.qk);
+		write_u32(out, rs.dest);
+		write_u32(out, rs.a);
+		write_u32(out, rs.pc);
+		write_u32(out, rs.next_j);
+		write_u32(out, rs.next_k);
+		write_u32(out, rs.unit);
+	}
+	for (unsigned i = 0; i < NUM_EXE_UNITS * ready_words; i++)
+	{
+		write_u64(out, ready_rs[i]);
+	}
+	write_u32(out, touched_count);
+	for (unsigned i = 0; i < touched_count; i++)
+	{
+		write_u32(out, touched_rs[i]);
+	}
+
+	//execution units and timing wheel
+	unsigned total_ex = size_of_int_ex + size_of_add_ex + size_of_mult_ex + size_of_div_ex + size_of_mem_ex;
+	for (unsigned i = 0; i < total_ex; i++)
+	{
+		ex_unit &ex = *ex_unit_from_id(i);
+		write_u32(out, ex.busy);
+		write_u32(out, ex.opcode);
+		write_u32(out, ex.vj);
+		write_u32(out, ex.vk);
+		write_u32(out, float2unsigned(ex.vjf));
+		write_u32(out, float2unsigned(ex.vkf));
+		write_u32(out, ex.delay);
+		write_u32(out, ex.finish);
+		write_u32(out, ex_unit_id(ex.next));
+		write_u32(out, ex.entry);
+		write_u32(out, ex.pc);
+	}
+	for (unsigned i = 0; i < wheel_size; i++)
+	{
+		write_u32(out, ex_unit_id(wheel[i]));
+	}
+	write_u32(out, ex_unit_id(releasing));
+
+	//rob and pending instructions
+	write_u32(out, rob_head);
+	write_u32(out, rob_tail);
+	write_u32(out, rob_count);
+	write_u64(out, rob_seq);
+	write_u32(out, retired_count);
+	for (unsigned i = 0; i < retired_count; i++)
+	{
+		write_u32(out, retired_entries[i]);
+	}
+	for (unsigned i = 0; i < size_of_rob; i++)
+	{
+		read_order_buffer &entry = rob[i];
+		write_u32(out, entry.entry);
+		write_u32(out, entry.busy | (entry.ready << 1) | (entry.commit_stall << 2) | (entry.traced << 3)
+			| (entry.predicted_taken << 4) | (entry.btb_miss << 5) | (entry.mispredicted << 6) | (entry.checkpointed << 7)
+			| (entry.delayed << 8));
+		write_u32(out, entry.opcode);
+		write_u32(out, entry.state);
+		write_u32(out, entry.destination);
+		write_u32(out, entry.value);
+		write_u32(out, float2unsigned(entry.value_f));
+		write_u32(out, entry.pc);
+		write_u64(out, entry.seq);
+		write_u64(out, entry.log_index);
+		write_u32(out, entry.waiters);
+		write_u32(out, entry.data_entry);
+		write_u64(out, entry.history);
+		for (unsigned r = 0; entry.checkpointed && r < 2 * NUM_GP_REGISTERS; r++)
 		{
-			answer = ex.pc + 4;
+			write_u32(out, rename_map[i * 2 * NUM_GP_REGISTERS + r]);
 		}
-		break;
-	case JUMP:
-		answer = (ex.vk * 4) + 4;
-		break;
-	case MULT:
-		answer = ex.vj * ex.vk;
-		break;
-	case DIV:
-		answer = ex.vj / ex.vk;
-		break;
+		write_u32(out, entry.traced ? rob_trace[i].value : 0); // only the result of a record is used once issued
+		write_u32(out, iq[i].pc);
+		write_u64(out, iq[i].Issue);
+		write_u64(out, iq[i].Exe);
+		write_u64(out, iq[i].WR);
+		write_u64(out, iq[i].Commit);
 	}
-	return answer;
+
+	//execution log
+	write_u64(out, instruction_log_limit);
+	write_u64(out, instruction_log_length);
+	for (unsigned long long i = 0; i < instruction_log_length; i++)
+	{
+		write_u32(out, il[i].pc);
+		write_u64(out, il[i].Issue);
+		write_u64(out, il[i].Exe);
+		write_u64(out, il[i].WR);
+		write_u64(out, il[i].Commit);
+	}
+	return !out.fail();
 }
 
-float sim_ooo::compute_result_fp(ex_unit ex)
+bool sim_ooo::restore_checkpoint(const char *filename)
 {
-	float answer = 0;
-	unsigned opcode = ex.opcode;
-	switch (opcode)
+	ifstream in(filename, ios::in | ios::binary);
+	if (!in.is_open())
 	{
-	case ADDS:
-		answer = ex.vjf + ex.vkf;
-		break;
-	case SUBS:
-		answer = ex.vjf - ex.vkf;
-		break;
-	case MULTS:
-		answer = ex.vjf * ex.vkf;
-		break;
-	case DIVS:
-		answer = ex.vjf / ex.vkf;
-		break;
+		return false;
 	}
-	return answer;
+	return restore_checkpoint(in);
 }
 
-int sim_ooo::compute_address_int(ex_unit ex)
+bool sim_ooo::restore_checkpoint(istream &in)
 {
-	int answer = 0;
-	if (ex.opcode == LW)
+	stop_functional_front();
+	delete[] rob_trace;
+	rob_trace = NULL;
+	char magic[sizeof(checkpoint_magic)];
+	in.read(magic, sizeof(magic));
+	if (!in || memcmp(magic, checkpoint_magic, sizeof(magic)) != 0 || read_u32(in) != CHECKPOINT_VERSION)
 	{
-		answer += data_memory[ex.vj + ex.vk + 3];
-		answer = answer << 8;
-		answer += data_memory[ex.vj + ex.vk + 2];
-		answer = answer << 8;
-		answer += data_memory[ex.vj + ex.vk + 1];
-		answer = answer << 8;
-		answer += data_memory[ex.vj + ex.vk + 0];
+		return false;
+	}
+
+	//configuration: rebuild every structure with the saved sizes
+	unsigned memory_size = read_u32(in);
+	unsigned rob_size = read_u32(in);
+	unsigned rs_sizes[4];
+	for (unsigned i = 0; i < 4; i++)
+	{
+		rs_sizes[i] = read_u32(in);
+	}
+	unsigned max_issue = read_u32(in);
+	unsigned max_commit = read_u32(in);
+	unsigned ex_sizes[NUM_EXE_UNITS];
+	for (unsigned u = 0; u < NUM_EXE_UNITS; u++)
+	{
+		ex_sizes[u] = read_u32(in);
+	}
+	unsigned saved_wheel_size = read_u32(in);
+	if (!in || rob_size == 0 || max_commit == 0 || (saved_wheel_size & (saved_wheel_size - 1)) != 0)
+	{
+		return false;
+	}
+
+	delete[] data_memory;
+	data_memory_size = memory_size;
+	data_memory = new unsigned char[data_memory_size];
+	memset(data_memory, 0xFF, data_memory_size);
+	issue_max = max_issue;
+	commit_max = max_commit;
+
+	delete[] all_rs;
+	delete[] ready_rs;
+	delete[] touched_rs;
+	size_of_int_rs = rs_sizes[0];
+	size_of_add_rs = rs_sizes[1];
+	size_of_mult_rs = rs_sizes[2];
+	size_of_load_rs = rs_sizes[3];
+	unsigned total_rs = size_of_int_rs + size_of_add_rs + size_of_mult_rs + size_of_load_rs;
+	all_rs = new reservation_station[total_rs];
+	int_rs = all_rs;
+	add_rs = int_rs + size_of_int_rs;
+	mult_rs = add_rs + size_of_add_rs;
+	load_rs = mult_rs + size_of_mult_rs;
+	ready_words = (total_rs + 63) / 64;
+	ready_rs = new unsigned long long[NUM_EXE_UNITS * ready_words];
+	touched_rs = new unsigned[total_rs];
+	for (unsigned i = 0; i < size_of_int_rs; i++)
+	{
+		int_rs[i].name = "Int" + to_string(i+1);
+	}
+	for (unsigned i = 0; i < size_of_add_rs; i++)
+	{
+		add_rs[i].name = "Add" + to_string(i+1);
+	}
+	for (unsigned i = 0; i < size_of_mult_rs; i++)
+	{
+		mult_rs[i].name = "Mult" + to_string(i+1);
+	}
+	for (unsigned i = 0; i < size_of_load_rs; i++)
+	{
+		load_rs[i].name = "Load" + to_string(i+1);
+	}
+
+	ex_unit **units[NUM_EXE_UNITS] = {&int_ex, &add_ex, &mult_ex, &div_ex, &mem_ex};
+	unsigned *unit_sizes[NUM_EXE_UNITS] = {&size_of_int_ex, &size_of_add_ex, &size_of_mult_ex, &size_of_div_ex, &size_of_mem_ex};
+	const char *unit_names[NUM_EXE_UNITS] = {"INT", "ADD", "MULT", "DIV", "MEM"};
+	for (unsigned u = 0; u < NUM_EXE_UNITS; u++)
+	{
+		delete[] *units[u];
+		*units[u] = ex_sizes[u] == 0 ? NULL : new ex_unit[ex_sizes[u]];
+		*unit_sizes[u] = ex_sizes[u];
+		for (unsigned i = 0; i < ex_sizes[u]; i++)
+		{
+			(*units[u])[i] = clear_ex_unit(unit_names[u] + to_string(i+1), 0, u + 1);
+		}
+	}
+	delete[] wheel;
+	wheel_size = saved_wheel_size;
+	wheel = wheel_size == 0 ? NULL : new ex_unit*[wheel_size];
+
+	delete[] rob;
+	delete[] retired_entries;
+	delete[] rename_map;
+	delete[] iq;
+	size_of_rob = rob_size;
+	rob = new read_order_buffer[size_of_rob];
+	retired_entries = new unsigned[size_of_rob];
+	rename_map = new unsigned[size_of_rob * 2 * NUM_GP_REGISTERS];
+	iq = new instruction_q[size_of_rob];
+
+	//program
+	base_Address = read_u32(in);
+	instruction_memory_size = read_u32(in);
+	unsigned program_size = read_u32(in);
+	delete[] instruction_memory;
+	instruction_memory = NULL;
+	if (program_size != 0)
+	{
+		instruction_memory = new unsigned int[program_size];
+		for (unsigned i = 0; i < program_size && in; i++)
+		{
+			instruction_memory[i] = read_u32(in);
+		}
+		decode_instruction_memory(program_size);
 	}
 	else
 	{
-		answer = ex.vj + ex.vk;
+		delete[] decoded_memory;
+		decoded_memory = NULL;
+		decoded_memory_size = 0;
+		decoded_memory_end = 0;
 	}
-	return answer;
-}
 
-float sim_ooo::compute_address_fp(ex_unit ex)
-{
-	float ans;
-	int answer = 0;
-	if (ex.opcode == LWS)
+	//data memory
+	unsigned chunks = (data_memory_size + CHECKPOINT_CHUNK - 1) / CHECKPOINT_CHUNK;
+	for (unsigned c = read_u32(in); in && c != UNDEFINED; c = read_u32(in))
 	{
-		answer += data_memory[ex.vj + ex.vk + 3];
-		answer = answer << 8;
-		answer += data_memory[ex.vj + ex.vk + 2];
-		answer = answer << 8;
-		answer += data_memory[ex.vj + ex.vk + 1];
-		answer = answer << 8;
-		answer += data_memory[ex.vj + ex.vk + 0];
-		ans = unsigned2float(answer);
+		if (c >= chunks)
+		{
+			return false;
+		}
+		unsigned start = c * CHECKPOINT_CHUNK;
+		unsigned length = data_memory_size - start < CHECKPOINT_CHUNK ? data_memory_size - start : CHECKPOINT_CHUNK;
+		in.read((char *)data_memory + start, length);
+	}
+
+	//counters and control state
+	pc = read_u32(in);
+	clock_cycles = read_u64(in);
+	instruction_count = read_u64(in);
+	stalls = read_u64(in);
+	commit_width_limited = read_u64(in);
+	commit_head_blocked = read_u64(in);
+	forwarded_loads = read_u64(in);
+	memory_conflicts = read_u64(in);
+	sample_count = read_u32(in);
+	sample_cpi_sum = unsigned2float_double(read_u64(in));
+	sample_cpi_square_sum = unsigned2float_double(read_u64(in));
+	eop = read_u32(in) != 0;
+	stalled = read_u32(in) != 0;
+	final_pc = read_u32(in);
+
+	//loop extrapolation
+	loop_extrapolation = read_u32(in) != 0;
+	loop_edge = false;
+	loop_body_length = read_u32(in);
+	if (loop_body_length != UNDEFINED && loop_body_length > LOOP_MAX_BODY)
+	{
+		return false;
+	}
+	for (unsigned i = 0; loop_body_length != UNDEFINED && i < loop_body_length; i++)
+	{
+		loop_body[i] = read_u32(in);
+	}
+	loop_last_length = read_u32(in);
+	if (loop_last_length != UNDEFINED && loop_last_length > LOOP_MAX_BODY)
+	{
+		return false;
+	}
+	for (unsigned i = 0; loop_last_length != UNDEFINED && i < loop_last_length; i++)
+	{
+		loop_last_body[i] = read_u32(in);
 	}
-	return ans;
-}
+	loop_fingerprint = read_u64(in);
+	loop_edge_cycles = read_u64(in);
+	loop_edge_stalls = read_u64(in);
+	loop_delta_cycles = read_u64(in);
+	loop_delta_stalls = read_u64(in);
+	loop_edge_limited = read_u64(in);
+	loop_edge_blocked = read_u64(in);
+	loop_delta_limited = read_u64(in);
+	loop_delta_blocked = read_u64(in);
+	loop_edge_branches = read_u64(in);
+	loop_edge_mispredictions = read_u64(in);
+	loop_edge_btb_misses = read_u64(in);
+	loop_edge_updates = read_u64(in);
+	loop_delta_branches = read_u64(in);
+	loop_delta_mispredictions = read_u64(in);
+	loop_delta_btb_misses = read_u64(in);
+	loop_edge_checkpoint_stalls = read_u64(in);
+	loop_delta_checkpoint_stalls = read_u64(in);
+	loop_edge_forwarded = read_u64(in);
+	loop_edge_conflicts = read_u64(in);
+	loop_delta_forwarded = read_u64(in);
+	loop_delta_conflicts = read_u64(in);
+	extrapolations = read_u64(in);
+	extrapolated_iterations = read_u64(in);
+	extrapolated_instructions = read_u64(in);
+	extrapolated_cycles = read_u64(in);
 
-void sim_ooo::write_rs(int answer, unsigned dest)
-{
-	int size, i;
-	size = size_of_int_rs;
-	for (i = 0; i < size; i++)
+	//branch prediction
+	branches = read_u64(in);
+	mispredictions = read_u64(in);
+	btb_misses = read_u64(in);
+	early_resolution = read_u32(in) != 0;
+	resolved_entry = UNDEFINED;
+	rename_checkpoints = read_u32(in);
+	checkpoints_in_use = read_u32(in);
+	checkpoint_stalls = read_u64(in);
+	if (rename_checkpoints == 0 || rename_checkpoints > size_of_rob || checkpoints_in_use > rename_checkpoints)
 	{
-		if (int_rs[i].qj == dest)
-		{
-			int_rs[i].qj = UNDEFINED;
-			int_rs[i].vj = answer;
-			int_rs[i].wb = true;
-		}
-		if (int_rs[i].qk == dest)
-		{
-			int_rs[i].qk = UNDEFINED;
-			int_rs[i].vk = answer;
-			int_rs[i].wb = true;
-		}
+		return false;
 	}
-	size = size_of_add_rs;
-	for (i = 0; i < size; i++)
+	delete_predictor(predictor);
+	predictor = NULL;
+	unsigned kind = read_u32(in);
+	if (kind > PREDICT_TAGE)
 	{
-		if (add_rs[i].qj == dest)
-		{
-			add_rs[i].qj = UNDEFINED;
-			add_rs[i].vj = answer;
-			add_rs[i].wb = true;
-		}
-		if (add_rs[i].qk == dest)
-		{
-			add_rs[i].qk = UNDEFINED;
-			add_rs[i].vk = answer;
-			add_rs[i].wb = true;
-		}
+		return false;
 	}
-	size = size_of_mult_rs;
-	for (i = 0; i < size; i++)
+	if (kind != PREDICT_NOT_TAKEN)
 	{
-		if (mult_rs[i].qj == dest)
-		{
-			mult_rs[i].qj = UNDEFINED;
-			mult_rs[i].vj = answer;
-			mult_rs[i].wb = true;
-		}
-		if (mult_rs[i].qk == dest)
+		unsigned index_bits = read_u32(in);
+		unsigned btb_size = read_u32(in);
+		if (!in || index_bits == 0 || index_bits > MAX_PREDICTOR_BITS || btb_size == 0
+			|| btb_size > (1u << MAX_PREDICTOR_BITS) || (btb_size & (btb_size - 1)) != 0)
 		{
-			mult_rs[i].qk = UNDEFINED;
-			mult_rs[i].vk = answer;
-			mult_rs[i].wb = true;
+			return false;
 		}
-	}
-	size = size_of_load_rs;
-	for (i = 0; i < size; i++)
-	{
-		if (load_rs[i].qj == dest)
+		predictor = new_predictor((predictor_t)kind, index_bits, btb_size);
+		in.read((char *)predictor->counters, 1u << index_bits);
+		for (unsigned i = 0; predictor->tagged != NULL && i < ((unsigned)TAGE_TABLES << index_bits); i++)
 		{
-			load_rs[i].qj = UNDEFINED;
-			load_rs[i].vj = answer;
-			load_rs[i].wb = true;
+			unsigned packed = read_u32(in);
+			predictor->tagged[i].tag = packed & 0xFFFF;
+			predictor->tagged[i].counter = (signed char)((packed >> 16) & 0xFF);
+			predictor->tagged[i].useful = packed >> 24;
 		}
-		if (load_rs[i].qk == dest)
+		for (unsigned i = 0; i < btb_size; i++)
 		{
-			load_rs[i].qk = UNDEFINED;
-			load_rs[i].vk = answer;
-			load_rs[i].wb = true;
+			predictor->btb_pc[i] = read_u32(in);
+			predictor->btb_target[i] = read_u32(in);
 		}
+		predictor->history = read_u64(in);
+		predictor->retired_history = read_u64(in);
+		predictor->updates = read_u64(in);
 	}
-}
 
-void sim_ooo::write_rs(float answer, unsigned dest)
-{
-	int size, i;
-	size = size_of_int_rs;
-	for (i = 0; i < size; i++)
+	//registers
+	for (unsigned i = 0; i < NUM_GP_REGISTERS; i++)
 	{
-		if (int_rs[i].qj == dest)
-		{
-			int_rs[i].qj = UNDEFINED;
-			int_rs[i].vjf = answer;
-			int_rs[i].wb = true;
-		}
-		if (int_rs[i].qk == dest)
-		{
-			int_rs[i].qk = UNDEFINED;
-			int_rs[i].vkf = answer;
-			int_rs[i].wb = true;
-		}
+		int_reg[i].value = read_u32(in);
+		int_reg[i].entry = read_u32(in);
+		fp_reg[i].value = unsigned2float(read_u32(in));
+		fp_reg[i].entry = read_u32(in);
 	}
-	size = size_of_add_rs;
-	for (i = 0; i < size; i++)
+
+	//reservation stations
+	for (unsigned i = 0; i < total_rs; i++)
 	{
-		if (add_rs[i].qj == dest)
-		{
-			add_rs[i].qj = UNDEFINED;
-			add_rs[i].vjf = answer;
-			add_rs[i].wb = true;
-		}
-		if (add_rs[i].qk == dest)
+		reservation_station &rs = all_rs[i];
+		unsigned flags = read_u32(in);
+		rs.busy = (flags & 1) != 0;
+		rs.wb = (flags & 2) != 0;
+		rs.cleared = (flags & 4) != 0;
+		rs.opcode = read_u32(in);
+		rs.vj = read_u32(in);
+		rs.vk = read_u32(in);
+		rs.vjf = unsigned2float(read_u32(in));
+		rs.vkf = unsigned2float(read_u32(in));
+		rs.qj = read_u32(in);
+		rs.qk = read_u32(in);
+		rs.dest = read_u32(in);
+		rs.a = read_u32(in);
+		rs.pc = read_u32(in);
+		rs.next_j = read_u32(in);
+		rs.next_k = read_u32(in);
+		rs.unit = read_u32(in);
+	}
+	for (unsigned i = 0; i < NUM_EXE_UNITS * ready_words; i++)
+	{
+		ready_rs[i] = read_u64(in);
+	}
+	touched_count = read_u32(in);
+	if (touched_count > total_rs)
+	{
+		return false;
+	}
+	for (unsigned i = 0; i < touched_count; i++)
+	{
+		touched_rs[i] = read_u32(in);
+	}
+
+	//execution units and timing wheel
+	unsigned total_ex = size_of_int_ex + size_of_add_ex + size_of_mult_ex + size_of_div_ex + size_of_mem_ex;
+	for (unsigned i = 0; i < total_ex; i++)
+	{
+		ex_unit &ex = *ex_unit_from_id(i);
+		ex.busy = read_u32(in) != 0;
+		ex.opcode = read_u32(in);
+		ex.vj = read_u32(in);
+		ex.vk = read_u32(in);
+		ex.vjf = unsigned2float(read_u32(in));
+		ex.vkf = unsigned2float(read_u32(in));
+		ex.delay = read_u32(in);
+		ex.finish = read_u32(in);
+		unsigned next = read_u32(in);
+		if (next != UNDEFINED && next >= total_ex)
 		{
-			add_rs[i].qk = UNDEFINED;
-			add_rs[i].vkf = answer;
-			add_rs[i].wb = true;
+			return false;
 		}
+		ex.next = ex_unit_from_id(next);
+		ex.entry = read_u32(in);
+		ex.pc = read_u32(in);
 	}
-	size = size_of_mult_rs;
-	for (i = 0; i < size; i++)
+	for (unsigned i = 0; i < wheel_size + 1; i++)
 	{
-		if (mult_rs[i].qj == dest)
+		unsigned id = read_u32(in);
+		if (id != UNDEFINED && id >= total_ex)
+		{
+			return false;
+		}
+		if (i < wheel_size)
 		{
-			mult_rs[i].qj = UNDEFINED;
-			mult_rs[i].vjf = answer;
-			mult_rs[i].wb = true;
+			wheel[i] = ex_unit_from_id(id);
 		}
-		if (mult_rs[i].qk == dest)
+		else
 		{
-			mult_rs[i].qk = UNDEFINED;
-			mult_rs[i].vkf = answer;
-			mult_rs[i].wb = true;
+			releasing = ex_unit_from_id(id);
 		}
 	}
-	size = size_of_load_rs;
-	for (i = 0; i < size; i++)
+
+	//rob and pending instructions
+	rob_head = read_u32(in);
+	rob_tail = read_u32(in);
+	rob_count = read_u32(in);
+	rob_seq = read_u64(in);
+	retired_count = read_u32(in);
+	if (rob_head >= size_of_rob || rob_tail >= size_of_rob || rob_count > size_of_rob || retired_count > size_of_rob)
+	{
+		return false;
+	}
+	for (unsigned i = 0; i < retired_count; i++)
+	{
+		retired_entries[i] = read_u32(in);
+	}
+	for (unsigned i = 0; i < size_of_rob; i++)
 	{
-		if (load_rs[i].qj == dest)
+		read_order_buffer &entry = rob[i];
+		entry.entry = read_u32(in);
+		unsigned flags = read_u32(in);
+		entry.busy = (flags & 1) != 0;
+		entry.ready = (flags & 2) != 0;
+		entry.commit_stall = (flags & 4) != 0;
+		entry.traced = (flags & 8) != 0;
+		entry.predicted_taken = (flags & 16) != 0;
+		entry.btb_miss = (flags & 32) != 0;
+		entry.mispredicted = (flags & 64) != 0;
+		entry.checkpointed = (flags & 128) != 0;
+		entry.delayed = (flags & 256) != 0;
+		entry.opcode = read_u32(in);
+		entry.state = (stage_t)read_u32(in);
+		entry.destination = read_u32(in);
+		entry.value = read_u32(in);
+		entry.value_f = unsigned2float(read_u32(in));
+		entry.pc = read_u32(in);
+		entry.seq = read_u64(in);
+		entry.log_index = read_u64(in);
+		entry.waiters = read_u32(in);
+		entry.data_entry = read_u32(in);
+		if (entry.data_entry != UNDEFINED && entry.data_entry >= size_of_rob)
+		{
+			return false;
+		}
+		entry.history = read_u64(in);
+		for (unsigned r = 0; entry.checkpointed && r < 2 * NUM_GP_REGISTERS; r++)
 		{
-			load_rs[i].qj = UNDEFINED;
-			load_rs[i].vjf = answer;
-			load_rs[i].wb = true;
+			rename_map[i * 2 * NUM_GP_REGISTERS + r] = read_u32(in);
 		}
-		if (load_rs[i].qk == dest)
+		unsigned traced_value = read_u32(in);
+		if (entry.traced)
 		{
-			load_rs[i].qk = UNDEFINED;
-			load_rs[i].vkf = answer;
-			load_rs[i].wb = true;
+			if (rob_trace == NULL)
+			{
+				rob_trace = new dynamic_instruction[size_of_rob];
+			}
+			rob_trace[i].value = traced_value;
+			rob_trace[i].value_f = unsigned2float(traced_value);
 		}
+		iq[i].pc = read_u32(in);
+		iq[i].Issue = read_u64(in);
+		iq[i].Exe = read_u64(in);
+		iq[i].WR = read_u64(in);
+		iq[i].Commit = read_u64(in);
 	}
-}
 
-void sim_ooo::write_rob(int answer, unsigned entry)
-{
-	rob[entry].value = answer;
-	rob[entry].state = "WR";
-	iq[entry].WR = (unsigned)clock_cycles;
-	if ((rob[entry].instruction >> 26) == EOP)
+	//execution log
+	unsigned long long log_limit = read_u64(in);
+	unsigned long long log_length = read_u64(in);
+	if (!in || log_length > log_limit)
 	{
-		iq[entry].WR = UNDEFINED;
+		return false;
 	}
-	rob[entry].ready = true;
+	delete[] il;
+	il = NULL;
+	instruction_log_length = 0;
+	instruction_log_capacity = 0;
+	instruction_log_limit = log_limit;
+	for (unsigned long long i = 0; i < log_length && in; i++)
+	{
+		unsigned long long index = add_il(read_u32(in));
+		il[index].Issue = read_u64(in);
+		il[index].Exe = read_u64(in);
+		il[index].WR = read_u64(in);
+		il[index].Commit = read_u64(in);
+	}
+
+	return !in.fail();
 }
 
-void sim_ooo::write_rob(float answer, unsigned entry)
+//reusable barrier for the threads of a multi-core run
+struct quantum_barrier
 {
-	rob[entry].value = float2unsigned(answer);
-	rob[entry].value_f = answer;
-	rob[entry].state = "WR";
-	iq[entry].WR = (unsigned)clock_cycles;
-	rob[entry].ready = true;
-}
+	mutex lock;
+	condition_variable released;
+	unsigned threads;
+	unsigned waiting;
+	unsigned long long generation; //number of times the barrier was released
+};
 
-ex_unit sim_ooo::clear_ex_unit(std::string name, unsigned delay)
+static void wait_barrier(quantum_barrier &b)
 {
-	ex_unit ex;
-	ex.name = name;
-	ex.busy = false;
-	ex.entry = UNDEFINED;
-	ex.opcode = UNDEFINED;
-	ex.ttf = UNDEFINED;
-	ex.delay = delay;
-	ex.vj = UNDEFINED;
-	ex.vk = UNDEFINED;
-	ex.vjf = (float)UNDEFINED;
-	ex.vkf = (float)UNDEFINED;
-	return ex;
+	unique_lock<mutex> guard(b.lock);
+	unsigned long long generation = b.generation;
+	if (++b.waiting == b.threads)
+	{
+		b.waiting = 0;
+		b.generation++;
+		b.released.notify_all();
+	}
+	else
+	{
+		b.released.wait(guard, [&]() { return b.generation != generation; });
+	}
 }
 
-void sim_ooo::flush_rob()
-{
-	int size = size_of_rob;
-	for (int i = 0; i < size; i++)
+sim_multicore::sim_multicore(unsigned num_cores,
+		unsigned mem_size,
+		unsigned rob_size,
+		unsigned num_int_res_stations,
+		unsigned num_add_res_stations,
+		unsigned num_mul_res_stations,
+		unsigned num_load_buffers,
+		unsigned issue_width,
+		unsigned commit_width){
+	this->num_cores = num_cores;
+	quanta = 0;
+	cores = new sim_ooo*[num_cores];
+	for (unsigned i = 0; i < num_cores; i++)
 	{
-		rob[i].entry = 1+i;
-		rob[i].busy = false;
-		rob[i].destination = "";
-		rob[i].pc = UNDEFINED;
-		rob[i].instruction = UNDEFINED;
-		rob[i].ready = false;
-		rob[i].state = "";
-		rob[i].value = UNDEFINED;
-		rob[i].value_f = (float)UNDEFINED;
-		rob[i].commit_stall = false;
-		open_rob_entry = 0;
+		cores[i] = new sim_ooo(mem_size, rob_size, num_int_res_stations, num_add_res_stations,
+			num_mul_res_stations, num_load_buffers, issue_width, commit_width);
+	}
+}
 
-		iq[i].pc = UNDEFINED;
-		iq[i].Issue = UNDEFINED;
-		iq[i].Exe = UNDEFINED;
-		iq[i].WR = UNDEFINED;
-		iq[i].Commit = UNDEFINED;
+sim_multicore::~sim_multicore()
+{
+	for (unsigned i = 0; i < num_cores; i++)
+	{
+		delete cores[i];
 	}
+	delete[] cores;
 }
 
-read_order_buffer sim_ooo::clear_rob_entry(unsigned entry)
+sim_ooo *sim_multicore::core(unsigned id)
 {
-	read_order_buffer empty;
-	empty.entry = entry;
-	empty.busy = false;
-	empty.destination = "";
-	empty.pc = UNDEFINED;
-	empty.instruction = UNDEFINED;
-	empty.ready = false;
-	empty.state = "";
-	empty.value = UNDEFINED;
-	empty.value_f = (float)UNDEFINED;
-	empty.commit_stall = true;
-	return empty;
+	return cores[id];
 }
 
-void sim_ooo::flush_ex()
+unsigned sim_multicore::get_num_cores()
 {
-	int size = size_of_int_ex;
-	for (int i = 0; i < size; i++)
-	{
-		int_ex[i] = clear_ex_unit(int_ex[i].name,int_ex[i].delay);
-	}
-	size = size_of_add_ex;
-	for (int i = 0; i < size; i++)
-	{
-		add_ex[i] = clear_ex_unit(add_ex[i].name, add_ex[i].delay);
-	}
-	size = size_of_mult_ex;
-	for (int i = 0; i < size; i++)
-	{
-		mult_ex[i] = clear_ex_unit(mult_ex[i].name, mult_ex[i].delay);
-	}
-	size = size_of_div_ex;
-	for (int i = 0; i < size; i++)
-	{
-		div_ex[i] = clear_ex_unit(div_ex[i].name, div_ex[i].delay);
-	}
-	size = size_of_mem_ex;
-	for (int i = 0; i < size; i++)
-	{
-		mem_ex[i] = clear_ex_unit(mem_ex[i].name, mem_ex[i].delay);
-	}
+	return num_cores;
 }
 
-void sim_ooo::flush_rs()
+void sim_multicore::write_memory(unsigned address, unsigned value)
 {
-	int size = size_of_int_rs;
-	for (int i = 0; i < size; i++)
-	{
-		int_rs[i] = clear_rs(int_rs[i].name);
-	}
-	size = size_of_add_rs;
-	for (int i = 0; i < size; i++)
-	{
-		add_rs[i] = clear_rs(add_rs[i].name);
-	}
-	size = size_of_mult_rs;
-	for (int i = 0; i < size; i++)
-	{
-		mult_rs[i] = clear_rs(mult_rs[i].name);
-	}
-	size = size_of_load_rs;
-	for (int i = 0; i < size; i++)
+	// every core keeps its own copy of the shared memory, equal to the others at each barrier
+	for (unsigned i = 0; i < num_cores; i++)
 	{
-		load_rs[i] = clear_rs(load_rs[i].name);
+		cores[i]->apply_store(address, value);
 	}
 }
 
-reservation_station sim_ooo::clear_rs(std::string name)
+void sim_multicore::print_memory(unsigned start_address, unsigned end_address)
 {
-	reservation_station rs;
-	rs.name = name;
-	rs.a = UNDEFINED;
-	rs.pc = UNDEFINED;
-	rs.busy = false;
-	rs.dest = UNDEFINED;
-	rs.opcode = UNDEFINED;
-	rs.qj = UNDEFINED;
-	rs.qk = UNDEFINED;
-	rs.vj = UNDEFINED;
-	rs.vk = UNDEFINED;
-	rs.vjf = unsigned2float(UNDEFINED);
-	rs.vkf = unsigned2float(UNDEFINED);
-	rs.wb = false;
-	rs.cleared = true;
-	return rs;
+	cores[0]->print_memory(start_address, end_address);
 }
 
-void sim_ooo::find_and_clear_rs(unsigned pc)
+void sim_multicore::barrier()
 {
-	int size = size_of_int_rs;
-	for (int i = 0; i < size; i++)
+	// every core applies all the stores, its own included, so that a location written by several cores in the
+	// same quantum ends with the value of the highest numbered one everywhere
+	for (unsigned c = 0; c < num_cores; c++)
 	{
-		if (int_rs[i].pc == pc)
+		unsigned length = cores[c]->get_store_log_length();
+		for (unsigned i = 0; i < length; i++)
 		{
-			int_rs[i] = clear_rs(int_rs[i].name);
-			return;
+			unsigned address, value;
+			cores[c]->get_logged_store(i, address, value);
+			for (unsigned d = 0; d < num_cores; d++)
+			{
+				cores[d]->apply_store(address, value);
+			}
 		}
 	}
-	size = size_of_add_rs;
-	for (int i = 0; i < size; i++)
+	for (unsigned c = 0; c < num_cores; c++)
 	{
-		if (add_rs[i].pc == pc)
-		{
-			add_rs[i] = clear_rs(add_rs[i].name);
-			return;
-		}
+		cores[c]->clear_store_log();
 	}
-	size = size_of_mult_rs;
-	for (int i = 0; i < size; i++)
+	quanta++;
+}
+
+void sim_multicore::run(unsigned quantum, unsigned threads)
+{
+	if (quantum == 0)
 	{
-		if (mult_rs[i].pc == pc)
-		{
-			mult_rs[i] = clear_rs(mult_rs[i].name);
-			return;
-		}
+		quantum = 1;
 	}
-	size = size_of_load_rs;
-	for (int i = 0; i < size; i++)
+	if (threads == 0 || threads > num_cores)
 	{
-		if (load_rs[i].pc == pc)
-		{
-			load_rs[i] = clear_rs(load_rs[i].name);
-			return;
-		}
+		threads = num_cores;
 	}
-}
-
-void sim_ooo::clear_write_back_check()
-{
-	int size, i;
-	size = size_of_int_rs;
-	for (i = 0; i < size; i++)
+	for (unsigned i = 0; i < num_cores; i++)
 	{
-		int_rs[i].wb = false;
-		int_rs[i].cleared = false;
+		cores[i]->set_store_log(true);
 	}
-	size = size_of_add_rs;
-	for (i = 0; i < size; i++)
+
+	// thread t runs cores t, t + threads, ...; thread 0 is this one and also passes the barriers
+	quantum_barrier done;
+	done.threads = threads;
+	done.waiting = 0;
+	done.generation = 0;
+	bool finished = false;
+	auto run_quanta = [&](unsigned t)
+	{
+		while (true)
+		{
+			for (unsigned i = t; i < num_cores; i += threads)
+			{
+				if (!cores[i]->finished())
+				{
+					cores[i]->run(quantum);
+				}
+			}
+			wait_barrier(done); // all cores have run the quantum
+			if (t == 0)
+			{
+				barrier();
+				finished = true;
+				for (unsigned i = 0; i < num_cores; i++)
+				{
+					finished = finished && cores[i]->finished();
+				}
+			}
+			wait_barrier(done); // memory is up to date for the next quantum
+			if (finished)
+			{
+				return;
+			}
+		}
+	};
+	thread *workers = new thread[threads - 1];
+	for (unsigned t = 1; t < threads; t++)
 	{
-		add_rs[i].wb = false;
-		add_rs[i].cleared = false;
+		workers[t - 1] = thread(run_quanta, t);
 	}
-	size = size_of_mult_rs;
-	for (i = 0; i < size; i++)
+	run_quanta(0);
+	for (unsigned t = 1; t < threads; t++)
 	{
-		mult_rs[i].wb = false;
-		mult_rs[i].cleared = false;
+		workers[t - 1].join();
 	}
-	size = size_of_load_rs;
-	for (i = 0; i < size; i++)
+	delete[] workers;
+
+	for (unsigned i = 0; i < num_cores; i++)
 	{
-		load_rs[i].wb = false;
-		load_rs[i].cleared = false;
+		cores[i]->set_store_log(false);
 	}
 }
 
-void sim_ooo::clear_commit_stall()
+unsigned long long sim_multicore::get_clock_cycles64()
 {
-	int size = size_of_rob;
-	for (int i = 0; i < size; i++)
+	unsigned long long cycles = 0;
+	for (unsigned i = 0; i < num_cores; i++)
 	{
-		rob[i].commit_stall = false;
+		if (cores[i]->get_clock_cycles64() > cycles)
+		{
+			cycles = cores[i]->get_clock_cycles64();
+		}
 	}
+	return cycles;
 }
 
-void sim_ooo::add_il(unsigned pc)
+unsigned long long sim_multicore::get_instructions_executed64()
 {
-	instruction_q* new_log = new instruction_q[instruction_log_length + 1]; // make new instruction log that is one longer
-	for (unsigned i = 0; i < instruction_log_length; i++) // copy the old log over to the new one
+	unsigned long long count = 0;
+	for (unsigned i = 0; i < num_cores; i++)
 	{
-		new_log[i] = il[i];
+		count += cores[i]->get_instructions_executed64();
 	}
-	
-	new_log[instruction_log_length].pc = pc;
-	new_log[instruction_log_length].Issue = (unsigned)clock_cycles;
-	il = new_log;
-	instruction_log_length++;
+	return count;
 }
 
-void sim_ooo::write_to_il(unsigned pc, unsigned stage)
+unsigned long long sim_multicore::get_quanta()
 {
-	int i;
-	for (i = instruction_log_length - 1; i >= 0; i--)
-	{
-		if (il[i].pc == pc) // find last entry that is equal and then stop searching
-		{
-			break;
-		}
-	}
-	switch (stage)
+	return quanta;
+}
+
+void sim_multicore::print_stats()
+{
+	cout << "MULTI-CORE STATISTICS" << endl;
+	cout << dec << "Quanta = " << quanta << endl;
+	for (unsigned i = 0; i < num_cores; i++)
 	{
-	case 1:
-		il[i].Issue = (unsigned)clock_cycles;
-		break;
-	case 2:
-		il[i].Exe = (unsigned)clock_cycles;
-		break;
-	case 3:
-		il[i].WR = (unsigned)clock_cycles;
-		break;
-	case 4:
-		il[i].Commit = (unsigned)clock_cycles;
-		break;
+		cout << "Core " << i << ": cycles = " << cores[i]->get_clock_cycles64() << ", instructions = "
+			<< cores[i]->get_instructions_executed64() << ", IPC = " << cores[i]->get_IPC() << endl;
 	}
-}
\ No newline at end of file
+	cout << "Cycles = " << get_clock_cycles64() << endl;
+	cout << "Instructions = " << get_instructions_executed64() << endl;
+}
@@ -12,7 +12,15 @@ using namespace std;
 #define NUM_GP_REGISTERS 32
 #define NUM_OPCODES 28
 #define NUM_STAGES 4
+#define NUM_EXE_UNITS 5 //number of execution unit types
 #define BTABLE 50 //size of table for recording branche labels
+#define UNDEFINED_SEQ 0xFFFFFFFFFFFFFFFFULL //sequence number of an empty rob entry
+#define UNDEFINED_CYCLE 0xFFFFFFFFFFFFFFFFULL //timestamp of a stage an instruction has not reached
+#define UNDEFINED_LOG 0xFFFFFFFFFFFFFFFFULL //log index of an instruction that is not in the execution log
+#define CHECKPOINT_VERSION 8 //format of the files written by save_checkpoint
+#define CHECKPOINT_CHUNK 4096 //data memory is saved in chunks of this many bytes, skipping chunks left at 0xFF
+#define TRACE_VERSION 2 //format of the files written by capture_trace
+#define TAGE_TABLES 4 //tagged tables of the TAGE predictor, with 4, 8, 16 and 32 branches of history
 
 typedef enum {LW = 1, SW = 2, ADD = 3, ADDI = 4, SUB = 5, SUBI = 06, XOR = 7, XORI = 8, OR = 9, ORI = 10, AND = 11, ANDI = 12, MULT = 13, DIV = 14, BEQZ = 15, BNEZ = 16, BLTZ = 17, BGTZ = 18, BLEZ = 19, BGEZ = 20, JUMP = 21, EOP = 22, LWS = 23, SWS = 24, ADDS = 25, SUBS = 26, MULTS = 27, DIVS = 28} opcode_t;
 
@@ -22,9 +30,18 @@ typedef enum {INTEGER = 1, ADDER = 2, MULTIPLIER = 3, DIVIDER = 4, MEMORY = 5} e
 
 typedef enum{ISSUE = 1, EXECUTE = 2, WRITE_RESULT = 3, COMMIT = 4} stage_t;
 
+typedef enum {PREDICT_NOT_TAKEN = 0, PREDICT_BIMODAL = 1, PREDICT_GSHARE = 2, PREDICT_TAGE = 3} predictor_t;
+
 struct reservation_station;
 struct ex_unit;
 struct read_order_buffer;
+struct int_register;
+struct fp_register;
+struct instruction_q;
+struct decoded_instruction;
+struct dynamic_instruction;
+struct functional_front;
+struct branch_predictor;
 
 class sim_ooo{
 
@@ -42,25 +59,108 @@ class sim_ooo{
 	//instruction memory
 	unsigned int *instruction_memory;
 
+	//pre-decoded copy of instruction memory used by the pipeline
+	decoded_instruction *decoded_memory;
+	unsigned decoded_memory_size;
+	unsigned decoded_memory_end; //one past the last word that holds an instruction
+
 	unsigned r_reg[NUM_GP_REGISTERS];
 	float f_reg[NUM_GP_REGISTERS];
 	unsigned opcode[NUM_OPCODES];
 
-	float clock_cycles;
-	float instruction_count;
-	float stalls;
+	unsigned long long clock_cycles;
+	unsigned long long instruction_count;
+	unsigned long long stalls;
+
+	//measurement windows of run_sampled
+	unsigned sample_count;
+	double sample_cpi_sum, sample_cpi_square_sum;
+
+	//steady-state loop detection: the instructions committed between two loop edges (backward branches or jumps
+	//that commit) form an iteration, compared with the previous one at the end of the cycle of each edge
+	bool loop_extrapolation; //set_loop_extrapolation
+	bool loop_edge; //a loop edge committed this cycle
+	unsigned *loop_body, *loop_last_body; //words of the instructions of the current and previous iteration
+	unsigned loop_body_length, loop_last_length; //UNDEFINED if the iteration was too long to record
+	unsigned long long loop_fingerprint; //pipeline state at the end of the previous iteration
+	unsigned long long loop_edge_cycles, loop_edge_stalls; //counters at the end of the previous iteration
+	unsigned long long loop_delta_cycles, loop_delta_stalls; //cycles and stalls of the previous iteration
+	unsigned long long loop_edge_limited, loop_edge_blocked; //commit counters at the end of the previous iteration
+	unsigned long long loop_delta_limited, loop_delta_blocked; //and their increase over it
+	unsigned long long loop_edge_branches, loop_edge_mispredictions, loop_edge_btb_misses, loop_edge_updates; //branch counters
+	unsigned long long loop_delta_branches, loop_delta_mispredictions, loop_delta_btb_misses; //and their increase
+	unsigned long long loop_edge_checkpoint_stalls, loop_delta_checkpoint_stalls;
+	unsigned long long loop_edge_forwarded, loop_edge_conflicts, loop_delta_forwarded, loop_delta_conflicts; //lsq counters
+	unsigned long long extrapolations, extrapolated_iterations, extrapolated_instructions, extrapolated_cycles;
 
 	bool eop;
 	bool stalled;
 
-	unsigned issue_max, open_rob_entry;
+	unsigned issue_max;
+	unsigned commit_max; //instructions retired per cycle at most
+
+	//retirement: cycles in which commit retired commit_max instructions and the next one was ready too,
+	//and cycles in which it was held by an instruction at the rob head that was not ready
+	unsigned long long commit_width_limited, commit_head_blocked;
+
+	//branch prediction: consulted at issue, trained when branches commit; NULL always predicts not taken
+	branch_predictor *predictor;
+	unsigned long long branches, mispredictions; //committed branches and jumps, and those that flushed the pipeline
+	unsigned long long btb_misses; //committed branches predicted taken that missed in the BTB
+
+	//mispredicted branches recover when they write their result instead of when they commit
+	bool early_resolution;
+	unsigned resolved_entry; //oldest branch found mispredicted in this cycle's write result, UNDEFINED if none
+
+	//rename checkpoints: each branch in flight saves the register alias table when it issues, and a branch
+	//that finds none free waits at issue
+	unsigned rename_checkpoints; //checkpoints available, at most one per rob entry
+	unsigned checkpoints_in_use;
+	unsigned *rename_map; //alias table saved by the branch in each rob entry: int then fp register entries
+	unsigned long long checkpoint_stalls; //cycles in which issue waited for a free checkpoint
+
+	//load/store queue, kept in rob order: loads that took their value from an older store still in the rob,
+	//and loads held back by an older store (address not computed, partial overlap or data not yet produced)
+	unsigned long long forwarded_loads, memory_conflicts;
+
+	//the rob is a circular fifo: instructions are allocated at rob_tail and retired from rob_head
+	unsigned rob_head, rob_tail, rob_count;
+	unsigned long long rob_seq; //sequence number given to the next issued instruction
+	unsigned *retired_entries; //entries retired this cycle, which cannot be reallocated until the next one
+	unsigned retired_count;
 	unsigned size_of_rob, size_of_int_rs, size_of_add_rs, size_of_mult_rs, size_of_load_rs,
 		size_of_int_ex, size_of_add_ex, size_of_mult_ex, size_of_div_ex, size_of_mem_ex;
-	unsigned instruction_log_length, final_pc;
+	unsigned final_pc;
+	unsigned long long instruction_log_length, instruction_log_capacity;
+	unsigned long long instruction_log_limit; //most entries kept in the execution log, 0 when it is off
+
+	//pipeline state - owned by this instance so that separate simulators never share data
+	reservation_station *all_rs; //int, add, mult and load stations in one block
+	reservation_station *int_rs, *add_rs, *mult_rs, *load_rs;
+	unsigned long long *ready_rs; //for each unit type, one bit per station of all_rs ready to execute on it
+	unsigned ready_words; //words per unit type in ready_rs
+	unsigned *touched_rs; //stations woken or freed this cycle, whose flags are cleared at the next commit
+	unsigned touched_count;
+	ex_unit *int_ex, *add_ex, *mult_ex, *div_ex, *mem_ex;
+	ex_unit **wheel; //timing wheel: units in flight, indexed by the cycle they finish in modulo wheel_size
+	unsigned wheel_size; //power of two larger than the longest latency
+	ex_unit *releasing; //units that wrote their result this cycle and are freed in the next one
+	read_order_buffer *rob;
+	int_register *int_reg;
+	fp_register *fp_reg;
+	instruction_q *iq, *il;
+	functional_front *front; //functional model running ahead on another thread, NULL if not started
+	dynamic_instruction *rob_trace; //record of each rob entry whose traced flag is set
+
+	//writes made through write_memory, as address and value pairs, while store_logging is set (multi-core mode)
+	bool store_logging;
+	unsigned *store_log;
+	unsigned store_log_length, store_log_capacity; //in pairs
 public:
 
 	/* Instantiates the simulator
           	Note: registers must be initialized to UNDEFINED value, and data memory to all 0xFF values
+		Note: all pipeline state is owned by the instance, so separate simulators can be run concurrently on separate threads
         */
 	sim_ooo(unsigned mem_size, 		// size of data memory (in byte)
 		unsigned rob_size, 		// number of ROB entries
@@ -68,7 +168,8 @@ public:
                 unsigned num_add_res_stations,	// number of ADD reservation stations
                 unsigned num_mul_res_stations, 	// number of MULT/DIV reservation stations
                 unsigned num_load_buffers,	// number of LOAD buffers
-		unsigned issue_width=1		// issue width
+		unsigned issue_width=1,		// issue width
+		unsigned commit_width=1		// commit width
         );	
 	
 	//de-allocates the simulator
@@ -83,8 +184,121 @@ public:
 	//loads the assembly program in file "filename" in instruction memory at the specified address
 	void load_program(const char *filename, unsigned base_address=0x0);
 
+	//decodes the first "size" words of instruction memory into decoded_memory
+	void decode_instruction_memory(unsigned size);
+
 	//runs the simulator for "cycles" clock cycles (run the program to completion if cycles=0) 
-	void run(unsigned cycles=0);
+	void run(unsigned long long cycles=0);
+
+	//returns true once the program has committed its EOP instruction
+	bool finished();
+
+	//executes up to "instructions" instructions functionally (no timing, clock_cycles and the log are left untouched)
+	//on the architectural registers and data memory, then returns the number executed; instructions still in flight
+	//are squashed first and re-executed, and the next run() continues in the detailed model from the resulting pc.
+	//Stops early before EOP, at the end of the program, or before a memory access outside data memory
+	unsigned long long fast_forward(unsigned long long instructions);
+
+	//runs the detailed model until "instructions" more instructions have committed or the program ends
+	void run_instructions(unsigned long long instructions);
+
+	//runs the program to completion by sampling: "functional" instructions are fast-forwarded, then "warmup"
+	//instructions run in the detailed model unmeasured, then the CPI of the next "measure" instructions is recorded
+	//as one sample; the cycle is repeated until the program ends. Samples are reset at the start.
+	//"measure" must be at least 1: with 0 the program runs to completion without samples
+	void run_sampled(unsigned long long functional, unsigned long long warmup, unsigned long long measure);
+
+	//runs the program to completion as slices of "interval" instructions simulated concurrently on "threads" threads
+	//(one per core if 0): an untimed pass saves the state "warmup" instructions ahead of every slice, each slice
+	//warms the pipeline up in detail from its snapshot and is then measured from the cycle in which the committed
+	//instructions reach its start to the one in which they reach the start of the next slice, and the cycles and
+	//instructions of the slices are added up. The registers and memory end as after run(); the log only holds the last slice
+	void run_parallel(unsigned long long interval, unsigned long long warmup, unsigned threads=0);
+
+	//starts executing the program functionally on a separate thread, from the committed state (instructions in
+	//flight are squashed first); the timing model then takes the results of the instructions on the program path
+	//from it instead of computing them. Registers and data memory must be set up before it is started, and
+	//load_program, fast_forward and restore_checkpoint stop it
+	void start_functional_front();
+
+	//stops the functional thread; instructions in flight are squashed and issued again by the timing model alone
+	void stop_functional_front();
+
+	//returns the functional record of the next instruction on the program path if it is the one at word "pc"
+	//(waiting for the producer if needed), NULL if there is none
+	dynamic_instruction *next_record(unsigned pc);
+
+	//attaches the record of the instruction at word "pc", just issued in rob entry "entry", and consumes it
+	void trace_issue(unsigned entry, unsigned pc);
+
+	//executes up to "instructions" instructions (to the end of the program if 0) functionally from the committed
+	//state, and writes the program, the initial registers and one record per instruction to "filename"; records
+	//are delta encoded against the program, so most take a few bits. The simulator itself is left unchanged.
+	//Returns false if the file cannot be written
+	bool capture_trace(const char *filename, unsigned long long instructions=0);
+
+	//replays the trace in "filename" through the timing model: the program and registers are loaded from the trace,
+	//results come from its records, and the simulation runs until all of them have committed (to completion if the
+	//trace reaches EOP). Data memory is not part of the trace, so only the timing and the registers are meaningful
+	//afterwards. Returns false if the file is not a trace
+	bool replay_trace(const char *filename);
+
+	//when enabled, run() (to completion) fingerprints the pipeline at the end of every loop iteration; once an
+	//iteration follows the same path, takes the same number of cycles and leaves the pipeline in the same state as
+	//the previous one, the following iterations are executed functionally and charged the same cycles each, until
+	//one would take another path, which is then simulated in detail. Timing stays exact since it does not depend on
+	//data values; get_extrapolated_instructions tells how much of a run was extrapolated
+	void set_loop_extrapolation(bool enabled);
+
+	//records the instruction committed from rob entry "entry" in the current loop iteration
+	void track_loop(unsigned entry);
+
+	//ends the current loop iteration and, if "extrapolate" is set and the loop is in a steady state, extrapolates it
+	void end_loop_iteration(bool extrapolate);
+
+	//hash of the pipeline state, with rob entries counted from the head and times from the current cycle
+	unsigned long long pipeline_fingerprint();
+
+	//executes the iterations that follow the path of the last one functionally and moves the clock and everything
+	//in flight forward by their cycles; instructions in flight take their results from the functional state
+	void extrapolate_loop();
+
+	//selects the branch predictor consulted at issue: PREDICT_NOT_TAKEN (the default) always falls through, the others
+	//use tables of 2^index_bits entries (the bimodal base and each tagged table of TAGE) and a direct-mapped BTB of
+	//"btb_entries" entries (rounded up to a power of two) that supplies the target of branches predicted taken.
+	//Issue continues at the predicted target; a mispredicted branch flushes the pipeline when it commits.
+	//The predictor starts cold and the branch counters are reset
+	void set_branch_predictor(predictor_t kind, unsigned index_bits=10, unsigned btb_entries=64);
+
+	//predicts the branch or jump at word "pc" just issued in rob entry "entry" and returns the word issue continues at
+	unsigned predict_branch(unsigned entry, unsigned pc);
+
+	//trains the predictor with the outcome of the branch committing from rob entry "entry"
+	void train_branch(unsigned entry, bool taken);
+
+	//when enabled, a mispredicted branch redirects issue as soon as it writes its result and squashes only the
+	//instructions issued after it (by rob sequence number), instead of flushing the whole pipeline when it commits
+	void set_early_resolution(bool enabled);
+
+	//squashes the instructions younger than the mispredicted branch in rob entry "entry" and redirects issue
+	void recover_branch(unsigned entry);
+
+	//limits the branches in flight to "count" rename checkpoints (0, the default, gives one to every rob entry)
+	void set_rename_checkpoints(unsigned count);
+
+	//saves the register alias table in the checkpoint of the branch just issued in rob entry "entry"
+	void save_rename_map(unsigned entry);
+
+	//brings the register alias table back to the checkpoint of the branch in rob entry "entry"; producers that
+	//have committed since it was saved are dropped
+	void restore_rename_map(unsigned entry);
+
+	//advances the clock over cycles in which no stage can make progress (at most "max_cycles")
+	//and returns the number of cycles skipped; the state afterwards is the same as stepping them one by one
+	unsigned long long skip_idle_cycles(unsigned long long max_cycles);
+
+	//returns true if one of the "size" execution units in "ex" is free
+	bool unit_free(ex_unit *ex, unsigned size);
 	
 	//resets the state of the simulator
         /* Note: 
@@ -94,6 +308,24 @@ public:
 	*/
 	void reset();
 
+	//writes the complete simulator state (configuration, registers, memories, pipeline, counters and log)
+	//to "filename" in binary form; returns false if the file cannot be written or the functional front is running
+	bool save_checkpoint(const char *filename);
+
+	//replaces the complete simulator state, configuration included, with the one saved in "filename";
+	//returns false if the file cannot be read or is not a checkpoint, in which case the simulator must not be run
+	bool restore_checkpoint(const char *filename);
+
+	//stream versions of the two above, for snapshots kept in memory
+	bool save_checkpoint(ostream &out);
+	bool restore_checkpoint(istream &in);
+
+	//returns the position of unit "ex" in the int, add, mult, div, mem order (UNDEFINED for NULL)
+	unsigned ex_unit_id(ex_unit *ex);
+
+	//returns the unit at position "id" in the int, add, mult, div, mem order (NULL for UNDEFINED)
+	ex_unit *ex_unit_from_id(unsigned id);
+
        //returns value of the specified integer general purpose register
         int get_int_register(unsigned reg);
 
@@ -121,12 +353,64 @@ public:
 	//returns the number of clock cycles 
 	unsigned get_clock_cycles();
 
+	//64-bit versions of the counters above, for runs longer than 2^32 cycles
+	unsigned long long get_instructions_executed64();
+	unsigned long long get_clock_cycles64();
+
+	//loop extrapolation counters: times a steady state was extrapolated, and the iterations, instructions
+	//and cycles accounted without being simulated in detail
+	unsigned long long get_extrapolations();
+	unsigned long long get_extrapolated_iterations();
+	unsigned long long get_extrapolated_instructions();
+	unsigned long long get_extrapolated_cycles();
+
+	//retirement counters: cycles limited by the commit width, and cycles blocked on a rob head that is not ready
+	unsigned long long get_commit_width_limited_cycles();
+	unsigned long long get_commit_head_blocked_cycles();
+
+	//branch counters: committed branches and jumps, mispredictions, BTB misses, the fraction predicted correctly
+	//and the mispredictions per thousand committed instructions
+	unsigned long long get_branches();
+	unsigned long long get_mispredictions();
+	unsigned long long get_btb_misses();
+	double get_branch_accuracy();
+	double get_MPKI();
+
+	//cycles in which issue waited for a rename checkpoint for the next branch
+	unsigned long long get_checkpoint_stalls();
+
+	//load/store queue counters: loads forwarded from an older store, and loads that had to wait for one
+	unsigned long long get_forwarded_loads();
+	unsigned long long get_memory_conflicts();
+
+	//returns the number of complete measurement windows recorded by run_sampled
+	unsigned get_samples();
+
+	//returns the CPI estimated by run_sampled (mean of the sampled CPIs)
+	double get_sampled_CPI();
+
+	//returns the half-width of the 95% confidence interval of get_sampled_CPI (0 with fewer than 2 samples)
+	double get_sampled_CPI_error();
+
 	//prints the content of the data memory within the specified address range
 	void print_memory(unsigned start_address, unsigned end_address);
 
 	// writes an integer value to data memory at the specified address (use little-endian format: https://en.wikipedia.org/wiki/Endianness)
 	void write_memory(unsigned address, unsigned value);
 
+	//starts or stops recording the writes made through write_memory (stores commit through it); the log is emptied
+	void set_store_log(bool enabled);
+
+	//returns the number of writes in the store log, and the address and value of write "index"
+	unsigned get_store_log_length();
+	void get_logged_store(unsigned index, unsigned &address, unsigned &value);
+
+	//empties the store log
+	void clear_store_log();
+
+	//writes "value" to data memory at "address" without recording it, to propagate the store of another core
+	void apply_store(unsigned address, unsigned value);
+
 	//prints the values of the registers 
 	void print_registers();
 
@@ -145,6 +429,25 @@ public:
 	//print the whole execution history 
 	void print_log();
 
+	//keeps at most "entries" instructions in the execution history printed by print_log (0 turns it off);
+	//later instructions are still simulated but not logged. The history is unbounded by default
+	void set_instruction_log_limit(unsigned long long entries);
+
+	//prints the estimate of the last sampled run
+	void print_sampling_stats();
+
+	//prints how much of the run was extrapolated by loop extrapolation
+	void print_extrapolation_stats();
+
+	//prints the commit width and how often retirement was limited by it or blocked by the rob head
+	void print_commit_stats();
+
+	//prints the branch predictor in use with its accuracy and MPKI
+	void print_branch_stats();
+
+	//prints how many loads were forwarded from older stores or held back by them
+	void print_lsq_stats();
+
 	//returns the decimal value/address of a register
 	unsigned get_register_value(std::string str);
 
@@ -167,21 +470,57 @@ public:
 
 	void execute();
 
+	//moves the ready instruction in the lowest-indexed station for the given unit type (not necessarily the oldest
+	//in program order) into a free unit of "ex"
+	void dispatch(ex_unit *ex, unsigned size, unsigned unit);
+
+	//marks station "station" of all_rs as ready to execute on its unit
+	void set_ready(unsigned station);
+
+	//removes station "station" of all_rs from the ready masks
+	void clear_ready(unsigned station);
+
+	//returns the lowest station of all_rs ready to execute on the given unit, -1 if none
+	int first_ready(unsigned unit);
+
+	//same as first_ready(MEMORY), but skips the loads that must still wait for an older store
+	int first_ready_memory();
+
+	//returns the youngest store older than the load in rob entry "load" that writes the word at "address", UNDEFINED
+	//if the load reads memory; sets "blocked" if the load cannot execute yet because an older store has no address,
+	//overlaps the word without matching it, or matches it before the stored value is produced
+	unsigned find_older_store(unsigned load, unsigned address, bool &blocked);
+
+	//returns the word the store in rob entry "entry" writes, as far as it is known
+	unsigned store_data(unsigned entry);
+
+	//records that a station's wb or cleared flag is about to be set this cycle
+	void touch_rs(unsigned station);
+
 	void write_result();
 
+	//writes the result of an execution unit that finishes this cycle
+	void write_unit_result(ex_unit &ex);
+
+	//places a unit that starts executing this cycle into the timing wheel slot of the cycle it finishes in
+	void schedule_ex_unit(ex_unit *ex);
+
 	void commit();
 
 	int get_open_rs(reservation_station *rs);
 
 	int get_open_rob(read_order_buffer *rob);
 
-	void write_to_rob_issue(unsigned instruction, unsigned open_rob, unsigned pc, unsigned destination, bool int_or_float);
+	void write_to_rob_issue(unsigned opcode, unsigned open_rob, unsigned pc, unsigned destination, bool int_or_float);
 
 	void write_to_rs(unsigned open_rs, unsigned rs, unsigned opcode, bool int_or_float, int vj, int vk, float vjf, float vkf, unsigned qj, unsigned qk, unsigned pc, unsigned a, unsigned open_rob);
 
+	//links operand j (or k) of station "station" of all_rs into the waiter list of rob entry "tag"
+	void add_waiter(unsigned station, unsigned tag, bool k);
+
 	unsigned get_q(unsigned i, bool int_or_float);
 
-	bool station_ready(reservation_station rs);
+	bool station_ready(const reservation_station &rs);
 
 	int compute_result_int(ex_unit ex);
 
@@ -199,7 +538,7 @@ public:
 
 	void write_rob(float answer, unsigned entry);
 
-	ex_unit clear_ex_unit(std::string name, unsigned delay);
+	ex_unit clear_ex_unit(std::string name, unsigned delay, unsigned type);
 
 	void flush_rob();
 
@@ -211,15 +550,74 @@ public:
 
 	reservation_station clear_rs(std::string name);
 
-	void find_and_clear_rs(unsigned pc);
+	//frees the reservation station holding the instruction of rob entry "entry"
+	void find_and_clear_rs(unsigned entry);
 
 	void clear_write_back_check();
 
 	void clear_commit_stall();
 
-	void add_il(unsigned pc);
+	//appends an issued instruction to the execution log and returns its log index (UNDEFINED_LOG if the log is full or off)
+	unsigned long long add_il(unsigned pc);
+
+	//records the current clock cycle for the given stage of the log entry at "index"
+	void write_to_il(unsigned long long index, unsigned stage);
+};
+
+//several out-of-order cores, each with its own program and pipeline, over one data memory. Cores advance in quanta of
+//cycles on separate threads; the stores of a quantum become visible to the other cores at the barrier that ends it,
+//in core order and in commit order within a core, so results do not depend on the threads. Within a quantum a core
+//sees the memory of the last barrier and its own stores
+class sim_multicore{
+
+	sim_ooo **cores;
+	unsigned num_cores;
+	unsigned long long quanta; //barriers passed so far
+
+public:
+
+	//instantiates "num_cores" identical cores; the arguments are those of sim_ooo
+	sim_multicore(unsigned num_cores,
+		unsigned mem_size,
+		unsigned rob_size,
+		unsigned num_int_res_stations,
+		unsigned num_add_res_stations,
+		unsigned num_mul_res_stations,
+		unsigned num_load_buffers,
+		unsigned issue_width=1,
+		unsigned commit_width=1
+	);
+
+	~sim_multicore();
+
+	//returns core "id", to add its execution units and load its program and registers
+	sim_ooo *core(unsigned id);
+
+	unsigned get_num_cores();
+
+	//writes an integer value to the shared data memory at the specified address
+	void write_memory(unsigned address, unsigned value);
+
+	//prints the content of the shared data memory within the specified address range
+	void print_memory(unsigned start_address, unsigned end_address);
+
+	//runs every core to the end of its program, "quantum" cycles at a time, on "threads" threads (one per core if 0)
+	void run(unsigned quantum, unsigned threads=0);
+
+	//makes the stores logged by every core since the last barrier visible to all of them
+	void barrier();
+
+	//returns the clock cycle in which the last core finished
+	unsigned long long get_clock_cycles64();
+
+	//returns the number of instructions executed by all cores
+	unsigned long long get_instructions_executed64();
+
+	//returns the number of quanta simulated
+	unsigned long long get_quanta();
 
-	void write_to_il(unsigned pc, unsigned stage);
+	//prints cycles, instructions and IPC of each core
+	void print_stats();
 };
 
 #endif /*SIM_OOO_H_*/
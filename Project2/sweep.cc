@@ -0,0 +1,518 @@
+#include "sim_ooo.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <stdlib.h>
+
+using namespace std;
+
+/* Design-space sweep driver for sim_ooo */
+
+/*
+  usage: sweep [-j threads] [-f csv|json] [-o output_file] grid_file
+
+  The grid file lists one parameter per line followed by the values to sweep.
+  Every combination of values is simulated with every program, and one row is
+  printed per point (in grid order, whatever the number of threads).
+
+	# comment
+	program asm/code_ooo.asm asm/code_ooo2.asm
+	memory_size 1048576
+	rob 6 8 16
+	int_rs 2
+	add_rs 2 4
+	mult_rs 2
+	load_rs 2
+	issue 1 2 4
+	commit 1 2
+	predictor bimodal tage    branch predictor: not-taken (the default), bimodal, gshare or tage
+	early_resolution 0 1      1 to recover from mispredictions at write result instead of commit
+	checkpoints 2 4           rename checkpoints for branches in flight (0, the default, is one per rob entry)
+	INTEGER 2:1               latency:instances of each execution unit type
+	ADDER 3:1 3:2
+	MULTIPLIER 10:1
+	DIVIDER 40:1
+	MEMORY 5:1
+	int_register 2 6          initial state, the same for every point
+	fp_register 1 0.0
+	memory 0xA000 0x3f800000  32-bit word written at the given address
+	max_cycles 1000000        optional cap for programs that may not terminate
+
+  Parameters that are not listed take the values of testcase1.
+*/
+
+static const char *unit_names[NUM_EXE_UNITS] = {"INTEGER", "ADDER", "MULTIPLIER", "DIVIDER", "MEMORY"};
+static const char *predictor_names[4] = {"not-taken", "bimodal", "gshare", "tage"}; //in predictor_t order
+
+struct unit_config
+{
+	unsigned latency;
+	unsigned instances;
+};
+
+//one simulated configuration
+struct sweep_point
+{
+	string program;
+	unsigned memory_size, rob, int_rs, add_rs, mult_rs, load_rs, issue, commit, predictor, early_resolution, checkpoints;
+	unit_config units[NUM_EXE_UNITS];
+};
+
+struct sweep_result
+{
+	unsigned long long cycles;
+	unsigned long long instructions;
+	unsigned long long branches, mispredictions;
+	unsigned long long checkpoint_stalls;
+	unsigned long long forwarded_loads, memory_conflicts;
+	bool completed; //false if max_cycles was reached before EOP
+};
+
+//values of every parameter, plus the initial state shared by all points
+struct sweep_grid
+{
+	vector<string> programs;
+	vector<unsigned> memory_size, rob, int_rs, add_rs, mult_rs, load_rs, issue, commit, predictor, early_resolution, checkpoints;
+	vector<unit_config> units[NUM_EXE_UNITS];
+	vector<pair<unsigned, int> > int_registers;
+	vector<pair<unsigned, float> > fp_registers;
+	vector<pair<unsigned, unsigned> > memory;
+	unsigned max_cycles;
+};
+
+static bool parse_unsigned(const string &token, unsigned &value)
+{
+	char *end;
+	value = (unsigned)strtoul(token.c_str(), &end, 0);
+	return !token.empty() && *end == '\0';
+}
+
+static bool parse_unsigned_list(istringstream &in, vector<unsigned> &values)
+{
+	values.clear();
+	string token;
+	unsigned value;
+	while (in >> token)
+	{
+		if (!parse_unsigned(token, value))
+		{
+			return false;
+		}
+		values.push_back(value);
+	}
+	return !values.empty();
+}
+
+static bool parse_grid(const char *filename, sweep_grid &grid)
+{
+	ifstream file(filename);
+	if (!file.is_open())
+	{
+		cerr << "sweep: cannot open " << filename << endl;
+		return false;
+	}
+
+	grid.memory_size.assign(1, 1024 * 1024);
+	grid.rob.assign(1, 6);
+	grid.int_rs.assign(1, 1);
+	grid.add_rs.assign(1, 2);
+	grid.mult_rs.assign(1, 2);
+	grid.load_rs.assign(1, 2);
+	grid.issue.assign(1, 1);
+	grid.commit.assign(1, 1);
+	grid.predictor.assign(1, PREDICT_NOT_TAKEN);
+	grid.early_resolution.assign(1, 0);
+	grid.checkpoints.assign(1, 0);
+	unit_config defaults[NUM_EXE_UNITS] = {{2, 1}, {2, 2}, {10, 1}, {40, 1}, {1, 1}};
+	for (unsigned u = 0; u < NUM_EXE_UNITS; u++)
+	{
+		grid.units[u].assign(1, defaults[u]);
+	}
+	grid.max_cycles = 0;
+
+	string line;
+	unsigned line_number = 0;
+	while (getline(file, line))
+	{
+		line_number++;
+		if (line.find('#') != string::npos)
+		{
+			line = line.substr(0, line.find('#'));
+		}
+		istringstream in(line);
+		string key;
+		if (!(in >> key))
+		{
+			continue;
+		}
+
+		bool ok = true;
+		if (key == "program")
+		{
+			string path;
+			while (in >> path)
+			{
+				if (!ifstream(path.c_str()).is_open())
+				{
+					cerr << "sweep: cannot open program " << path << endl;
+					return false;
+				}
+				grid.programs.push_back(path);
+			}
+		}
+		else if (key == "memory_size") ok = parse_unsigned_list(in, grid.memory_size);
+		else if (key == "rob") ok = parse_unsigned_list(in, grid.rob);
+		else if (key == "int_rs") ok = parse_unsigned_list(in, grid.int_rs);
+		else if (key == "add_rs") ok = parse_unsigned_list(in, grid.add_rs);
+		else if (key == "mult_rs") ok = parse_unsigned_list(in, grid.mult_rs);
+		else if (key == "load_rs") ok = parse_unsigned_list(in, grid.load_rs);
+		else if (key == "issue") ok = parse_unsigned_list(in, grid.issue);
+		else if (key == "commit") ok = parse_unsigned_list(in, grid.commit);
+		else if (key == "early_resolution") ok = parse_unsigned_list(in, grid.early_resolution);
+		else if (key == "checkpoints") ok = parse_unsigned_list(in, grid.checkpoints);
+		else if (key == "predictor")
+		{
+			grid.predictor.clear();
+			string name;
+			while (ok && in >> name)
+			{
+				unsigned kind;
+				for (kind = 0; kind < 4 && name != predictor_names[kind]; kind++);
+				ok = kind < 4;
+				grid.predictor.push_back(kind);
+			}
+			ok = ok && !grid.predictor.empty();
+		}
+		else if (key == "max_cycles")
+		{
+			string token;
+			ok = (in >> token) && parse_unsigned(token, grid.max_cycles);
+		}
+		else if (key == "int_register")
+		{
+			unsigned reg;
+			int value;
+			ok = (in >> reg >> value) && reg < NUM_GP_REGISTERS;
+			grid.int_registers.push_back(make_pair(reg, value));
+		}
+		else if (key == "fp_register")
+		{
+			unsigned reg;
+			float value;
+			ok = (in >> reg >> value) && reg < NUM_GP_REGISTERS;
+			grid.fp_registers.push_back(make_pair(reg, value));
+		}
+		else if (key == "memory")
+		{
+			string address, value;
+			unsigned a, v;
+			ok = (in >> address >> value) && parse_unsigned(address, a) && parse_unsigned(value, v);
+			grid.memory.push_back(make_pair(a, v));
+		}
+		else
+		{
+			unsigned u;
+			for (u = 0; u < NUM_EXE_UNITS; u++)
+			{
+				if (key == unit_names[u])
+				{
+					break;
+				}
+			}
+			ok = u < NUM_EXE_UNITS;
+			if (ok)
+			{
+				grid.units[u].clear();
+				string token;
+				while (ok && in >> token)
+				{
+					unit_config config;
+					size_t colon = token.find(':');
+					ok = colon != string::npos
+						&& parse_unsigned(token.substr(0, colon), config.latency)
+						&& parse_unsigned(token.substr(colon + 1), config.instances);
+					grid.units[u].push_back(config);
+				}
+				ok = ok && !grid.units[u].empty();
+			}
+		}
+
+		if (!ok)
+		{
+			cerr << "sweep: " << filename << ":" << line_number << ": invalid line \"" << line << "\"" << endl;
+			return false;
+		}
+	}
+
+	if (grid.programs.empty())
+	{
+		cerr << "sweep: " << filename << " does not list any program" << endl;
+		return false;
+	}
+	return true;
+}
+
+//expands the grid into the list of points, the last parameter varying fastest
+static vector<sweep_point> expand_grid(const sweep_grid &grid)
+{
+	const vector<unsigned> *values[] = {&grid.memory_size, &grid.rob, &grid.int_rs, &grid.add_rs, &grid.mult_rs, &grid.load_rs, &grid.issue, &grid.commit, &grid.predictor, &grid.early_resolution, &grid.checkpoints};
+	const unsigned num_values = sizeof(values) / sizeof(values[0]);
+	unsigned sizes[num_values + NUM_EXE_UNITS];
+	unsigned long long total = grid.programs.size();
+	for (unsigned d = 0; d < num_values + NUM_EXE_UNITS; d++)
+	{
+		sizes[d] = d < num_values ? values[d]->size() : grid.units[d - num_values].size();
+		total *= sizes[d];
+	}
+
+	vector<sweep_point> points;
+	points.reserve(total);
+	for (unsigned long long n = 0; n < total; n++)
+	{
+		unsigned index[num_values + NUM_EXE_UNITS];
+		unsigned long long rest = n;
+		for (int d = num_values + NUM_EXE_UNITS - 1; d >= 0; d--)
+		{
+			index[d] = rest % sizes[d];
+			rest /= sizes[d];
+		}
+
+		sweep_point point;
+		point.program = grid.programs[rest];
+		point.memory_size = grid.memory_size[index[0]];
+		point.rob = grid.rob[index[1]];
+		point.int_rs = grid.int_rs[index[2]];
+		point.add_rs = grid.add_rs[index[3]];
+		point.mult_rs = grid.mult_rs[index[4]];
+		point.load_rs = grid.load_rs[index[5]];
+		point.issue = grid.issue[index[6]];
+		point.commit = grid.commit[index[7]];
+		point.predictor = grid.predictor[index[8]];
+		point.early_resolution = grid.early_resolution[index[9]];
+		point.checkpoints = grid.checkpoints[index[10]];
+		for (unsigned u = 0; u < NUM_EXE_UNITS; u++)
+		{
+			point.units[u] = grid.units[u][index[num_values + u]];
+		}
+		points.push_back(point);
+	}
+	return points;
+}
+
+static sweep_result simulate(const sweep_point &point, const sweep_grid &grid)
+{
+	sim_ooo sim(point.memory_size, point.rob, point.int_rs, point.add_rs, point.mult_rs, point.load_rs, point.issue, point.commit);
+	for (unsigned u = 0; u < NUM_EXE_UNITS; u++)
+	{
+		if (point.units[u].instances != 0)
+		{
+			sim.init_exec_unit((exe_unit_t)(u + 1), point.units[u].latency, point.units[u].instances);
+		}
+	}
+	sim.set_branch_predictor((predictor_t)point.predictor);
+	sim.set_early_resolution(point.early_resolution != 0);
+	sim.set_rename_checkpoints(point.checkpoints);
+	sim.set_instruction_log_limit(0); // only the totals are reported, so long runs need no execution log
+	sim.load_program(point.program.c_str(), 0x00000000);
+	for (unsigned i = 0; i < grid.int_registers.size(); i++)
+	{
+		sim.set_int_register(grid.int_registers[i].first, grid.int_registers[i].second);
+	}
+	for (unsigned i = 0; i < grid.fp_registers.size(); i++)
+	{
+		sim.set_fp_register(grid.fp_registers[i].first, grid.fp_registers[i].second);
+	}
+	for (unsigned i = 0; i < grid.memory.size(); i++)
+	{
+		sim.write_memory(grid.memory[i].first, grid.memory[i].second);
+	}
+
+	sim.run(grid.max_cycles);
+
+	sweep_result result;
+	result.cycles = sim.get_clock_cycles64();
+	result.instructions = sim.get_instructions_executed64();
+	result.branches = sim.get_branches();
+	result.mispredictions = sim.get_mispredictions();
+	result.checkpoint_stalls = sim.get_checkpoint_stalls();
+	result.forwarded_loads = sim.get_forwarded_loads();
+	result.memory_conflicts = sim.get_memory_conflicts();
+	result.completed = sim.finished();
+	return result;
+}
+
+//runs every point on "threads" worker threads; each worker takes the next point not yet simulated
+static vector<sweep_result> run_sweep(const vector<sweep_point> &points, const sweep_grid &grid, unsigned threads)
+{
+	vector<sweep_result> results(points.size());
+	atomic<size_t> next(0);
+	vector<thread> workers;
+	for (unsigned t = 0; t < threads; t++)
+	{
+		workers.push_back(thread([&]()
+		{
+			for (size_t i = next++; i < points.size(); i = next++)
+			{
+				results[i] = simulate(points[i], grid);
+			}
+		}));
+	}
+	for (unsigned t = 0; t < workers.size(); t++)
+	{
+		workers[t].join();
+	}
+	return results;
+}
+
+static string json_escape(const string &text)
+{
+	string escaped;
+	for (unsigned i = 0; i < text.size(); i++)
+	{
+		if (text[i] == '"' || text[i] == '\\')
+		{
+			escaped += '\\';
+		}
+		escaped += text[i];
+	}
+	return escaped;
+}
+
+static double ipc(const sweep_result &result)
+{
+	return result.cycles == 0 ? 0.0 : (double)result.instructions / (double)result.cycles;
+}
+
+static void print_csv(ostream &out, const vector<sweep_point> &points, const vector<sweep_result> &results)
+{
+	out << "program,memory_size,rob,int_rs,add_rs,mult_rs,load_rs,issue,commit,predictor,early_resolution,checkpoints";
+	for (unsigned u = 0; u < NUM_EXE_UNITS; u++)
+	{
+		out << "," << unit_names[u] << "_latency," << unit_names[u] << "_instances";
+	}
+	out << ",cycles,instructions,ipc,branches,mispredictions,checkpoint_stalls,forwarded_loads,memory_conflicts,completed" << endl;
+
+	for (unsigned i = 0; i < points.size(); i++)
+	{
+		const sweep_point &p = points[i];
+		out << p.program << "," << p.memory_size << "," << p.rob << "," << p.int_rs << "," << p.add_rs
+			<< "," << p.mult_rs << "," << p.load_rs << "," << p.issue << "," << p.commit << "," << predictor_names[p.predictor] << "," << p.early_resolution
+			<< "," << p.checkpoints;
+		for (unsigned u = 0; u < NUM_EXE_UNITS; u++)
+		{
+			out << "," << p.units[u].latency << "," << p.units[u].instances;
+		}
+		out << "," << results[i].cycles << "," << results[i].instructions << "," << setprecision(6) << ipc(results[i])
+			<< "," << results[i].branches << "," << results[i].mispredictions << "," << results[i].checkpoint_stalls
+			<< "," << results[i].forwarded_loads << "," << results[i].memory_conflicts << "," << (results[i].completed ? "yes" : "no") << endl;
+	}
+}
+
+static void print_json(ostream &out, const vector<sweep_point> &points, const vector<sweep_result> &results)
+{
+	out << "[" << endl;
+	for (unsigned i = 0; i < points.size(); i++)
+	{
+		const sweep_point &p = points[i];
+		out << "  {\"program\": \"" << json_escape(p.program) << "\", \"memory_size\": " << p.memory_size << ", \"rob\": " << p.rob
+			<< ", \"int_rs\": " << p.int_rs << ", \"add_rs\": " << p.add_rs << ", \"mult_rs\": " << p.mult_rs
+			<< ", \"load_rs\": " << p.load_rs << ", \"issue\": " << p.issue << ", \"commit\": " << p.commit
+			<< ", \"predictor\": \"" << predictor_names[p.predictor] << "\""
+			<< ", \"early_resolution\": " << (p.early_resolution != 0 ? "true" : "false")
+			<< ", \"checkpoints\": " << p.checkpoints;
+		for (unsigned u = 0; u < NUM_EXE_UNITS; u++)
+		{
+			out << ", \"" << unit_names[u] << "\": {\"latency\": " << p.units[u].latency
+				<< ", \"instances\": " << p.units[u].instances << "}";
+		}
+		out << ", \"cycles\": " << results[i].cycles << ", \"instructions\": " << results[i].instructions
+			<< ", \"ipc\": " << setprecision(6) << ipc(results[i])
+			<< ", \"branches\": " << results[i].branches << ", \"mispredictions\": " << results[i].mispredictions
+			<< ", \"checkpoint_stalls\": " << results[i].checkpoint_stalls
+			<< ", \"forwarded_loads\": " << results[i].forwarded_loads << ", \"memory_conflicts\": " << results[i].memory_conflicts
+			<< ", \"completed\": " << (results[i].completed ? "true" : "false") << "}"
+			<< (i + 1 < points.size() ? "," : "") << endl;
+	}
+	out << "]" << endl;
+}
+
+int main(int argc, char **argv)
+{
+	unsigned threads = thread::hardware_concurrency();
+	string format = "csv";
+	const char *output = NULL;
+	const char *grid_file = NULL;
+
+	for (int i = 1; i < argc; i++)
+	{
+		string arg = argv[i];
+		if (arg == "-j" && i + 1 < argc)
+		{
+			threads = (unsigned)atoi(argv[++i]);
+		}
+		else if (arg == "-f" && i + 1 < argc)
+		{
+			format = argv[++i];
+		}
+		else if (arg == "-o" && i + 1 < argc)
+		{
+			output = argv[++i];
+		}
+		else if (grid_file == NULL && arg[0] != '-')
+		{
+			grid_file = argv[i];
+		}
+		else
+		{
+			grid_file = NULL;
+			break;
+		}
+	}
+	if (grid_file == NULL || (format != "csv" && format != "json"))
+	{
+		cerr << "usage: " << argv[0] << " [-j threads] [-f csv|json] [-o output_file] grid_file" << endl;
+		return 1;
+	}
+	if (threads == 0)
+	{
+		threads = 1;
+	}
+
+	sweep_grid grid;
+	if (!parse_grid(grid_file, grid))
+	{
+		return 1;
+	}
+	vector<sweep_point> points = expand_grid(grid);
+	if (threads > points.size())
+	{
+		threads = points.size();
+	}
+	vector<sweep_result> results = run_sweep(points, grid, threads);
+
+	ofstream file;
+	if (output != NULL)
+	{
+		file.open(output);
+		if (!file.is_open())
+		{
+			cerr << "sweep: cannot open " << output << endl;
+			return 1;
+		}
+	}
+	ostream &out = output != NULL ? file : cout;
+	if (format == "csv")
+	{
+		print_csv(out, points, results);
+	}
+	else
+	{
+		print_json(out, points, results);
+	}
+	return 0;
+}
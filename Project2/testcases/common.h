@@ -0,0 +1,59 @@
+#ifndef COMMON_H_
+#define COMMON_H_
+
+#include "sim_ooo.h"
+#include <iostream>
+#include <sstream>
+#include <string.h>
+
+using namespace std;
+
+/* Set-up shared by the testcases that compare several runs of the sort program of testcase10 */
+
+/* convert a float into an unsigned */
+inline unsigned float2unsigned(float value){
+        unsigned result;
+        memcpy(&result, &value, sizeof value);
+        return result;
+}
+
+/* instantiates the processor of testcase10 (with the given commit width) and loads the sort program with the */
+/* numbers 12 down to 1 */
+inline sim_ooo *new_sort_sim(unsigned commit_width=1){
+	unsigned i, j;
+
+	sim_ooo *ooo = new sim_ooo(1024*1024,	//memory size
+				   6,           //rob size
+				   3, 2, 2, 2,  //int, add, mult, load reservation stations
+				   2, 		//issue width
+				   commit_width);
+
+	ooo->init_exec_unit(INTEGER, 3, 2);
+	ooo->init_exec_unit(ADDER, 3, 2);
+	ooo->init_exec_unit(MULTIPLIER, 10, 1);
+	ooo->init_exec_unit(DIVIDER, 40, 1);
+	ooo->init_exec_unit(MEMORY, 5, 1);
+
+	ooo->load_program("asm/sort.asm", 0x00000000);
+	ooo->set_int_register(7, 0x80000000);
+	for (i = 0xA000, j=12; i<0xA030; i+=4, j-=1) ooo->write_memory(i,float2unsigned((float)(j)));
+	return ooo;
+}
+
+/* registers and sorted numbers (unless "memory" is false) at the end of a run: two runs with the same */
+/* architectural result give the same string */
+inline string final_state(sim_ooo *ooo, bool memory=true){
+	stringstream state;
+	streambuf *cout_buffer = cout.rdbuf(state.rdbuf());
+	ios::fmtflags cout_flags = cout.flags();
+	ooo->print_registers();
+	if (memory)
+	{
+		ooo->print_memory(0xB000, 0xB030);
+	}
+	cout.flags(cout_flags);
+	cout.rdbuf(cout_buffer);
+	return state.str();
+}
+
+#endif /*COMMON_H_*/
@@ -0,0 +1,66 @@
+#include "common.h"
+#include <fstream>
+#include <stdio.h>
+
+/* Test case for checkpoints: the sort program saved after 300 cycles and finished by another simulator */
+/* must end in the same state as an uninterrupted run, and bad checkpoints must be rejected */
+
+/* writes a copy of checkpoint "image" with the 32-bit little-endian field at "offset" set to "value" */
+inline void write_patched(const char *filename, string image, unsigned offset, unsigned value){
+        for (unsigned i = 0; i < 4; i++) image[offset + i] = (char)((value >> (8 * i)) & 0xFF);
+        ofstream out(filename, ios::out | ios::binary);
+        out.write(image.data(), image.size());
+}
+
+int main(int argc, char **argv){
+
+	sim_ooo *reference = new_sort_sim();
+	reference->run();
+	cout << "\nUNINTERRUPTED RUN..." << endl;
+	cout << "======================================================================" << endl << endl;
+	cout << final_state(reference);
+	cout << "Instruction executed = " << dec << reference->get_instructions_executed() << endl;
+	cout << "Clock cycles = " << dec << reference->get_clock_cycles() << endl;
+
+	cout << "\nCHECKPOINT AFTER 300 CYCLES..." << endl;
+	cout << "======================================================================" << endl << endl;
+
+	const char *checkpoint_file = "testcase11.ckp";
+	sim_ooo *first = new_sort_sim();
+	first->run(300);
+	cout << "Checkpoint saved = " << (first->save_checkpoint(checkpoint_file) ? "yes" : "no") << endl;
+	delete first;
+
+	sim_ooo *second = new_sort_sim();
+	cout << "Checkpoint restored = " << (second->restore_checkpoint(checkpoint_file) ? "yes" : "no") << endl;
+	cout << "Clock cycles at restore = " << dec << second->get_clock_cycles() << endl;
+	second->run();
+	cout << "Instruction executed = " << dec << second->get_instructions_executed() << endl;
+	cout << "Clock cycles = " << dec << second->get_clock_cycles() << endl;
+	cout << "Same registers, memory and cycles as the uninterrupted run = "
+	     << (final_state(second) == final_state(reference) && second->get_clock_cycles() == reference->get_clock_cycles() ? "yes" : "no") << endl;
+	delete second;
+
+	// the version follows the 8-byte magic, and the data memory size follows the version
+	cout << "\nBAD CHECKPOINTS..." << endl;
+	cout << "======================================================================" << endl << endl;
+
+	ifstream in(checkpoint_file, ios::in | ios::binary);
+	stringstream saved;
+	saved << in.rdbuf();
+	in.close();
+
+	write_patched(checkpoint_file, saved.str(), 8, CHECKPOINT_VERSION - 1);
+	sim_ooo *third = new_sort_sim();
+	cout << "Checkpoint of an older version restored = " << (third->restore_checkpoint(checkpoint_file) ? "yes" : "no") << endl;
+	delete third;
+
+	// a 4KB memory leaves the saved chunks of 0xA000 and 0xB000 out of range
+	write_patched(checkpoint_file, saved.str(), 12, 4096);
+	sim_ooo *fourth = new_sort_sim();
+	cout << "Out-of-range memory chunk restored = " << (fourth->restore_checkpoint(checkpoint_file) ? "yes" : "no") << endl;
+	delete fourth;
+
+	remove(checkpoint_file);
+	delete reference;
+}
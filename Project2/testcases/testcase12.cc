@@ -0,0 +1,33 @@
+#include "common.h"
+
+/* Test case for fast-forwarding: the sort program run functionally for N instructions and then in the */
+/* detailed model must end with the same registers and memory as a detailed run from the start */
+
+int main(int argc, char **argv){
+
+	sim_ooo *reference = new_sort_sim();
+	reference->run();
+	cout << "\nDETAILED RUN..." << endl;
+	cout << "======================================================================" << endl << endl;
+	cout << final_state(reference);
+	cout << "Instruction executed = " << dec << reference->get_instructions_executed() << endl;
+	cout << "Clock cycles = " << dec << reference->get_clock_cycles() << endl;
+
+	unsigned long long skipped[] = {100, 500, 1000000};
+	for (unsigned i = 0; i < 3; i++)
+	{
+		cout << "\nFAST-FORWARD " << skipped[i] << " INSTRUCTIONS, THEN DETAILED..." << endl;
+		cout << "======================================================================" << endl << endl;
+
+		sim_ooo *ooo = new_sort_sim();
+		cout << "Instructions fast-forwarded = " << dec << ooo->fast_forward(skipped[i]) << endl;
+		ooo->run();
+		cout << "Instruction executed = " << dec << ooo->get_instructions_executed() << endl;
+		cout << "Clock cycles = " << dec << ooo->get_clock_cycles() << endl;
+		cout << "Same registers and memory as the detailed run = "
+		     << (final_state(ooo) == final_state(reference) ? "yes" : "no") << endl;
+		delete ooo;
+	}
+
+	delete reference;
+}
@@ -0,0 +1,48 @@
+#include "common.h"
+
+/* Test case for sampled runs: the CPI estimated from sampled windows of the sort program must bracket */
+/* the CPI of a detailed run, and runs with an empty measurement window must end without samples */
+
+int main(int argc, char **argv){
+
+	sim_ooo *reference = new_sort_sim();
+	reference->run();
+	double cpi = (double)reference->get_clock_cycles() / reference->get_instructions_executed();
+	cout << "\nDETAILED RUN..." << endl;
+	cout << "======================================================================" << endl << endl;
+	cout << "Instruction executed = " << dec << reference->get_instructions_executed() << endl;
+	cout << "Clock cycles = " << dec << reference->get_clock_cycles() << endl;
+	cout << "CPI = " << cpi << endl;
+
+	cout << "\nSAMPLED RUN: 50 FAST-FORWARDED, 20 WARMUP, 30 MEASURED..." << endl;
+	cout << "======================================================================" << endl << endl;
+
+	sim_ooo *ooo = new_sort_sim();
+	ooo->run_sampled(50, 20, 30);
+	ooo->print_sampling_stats();
+	cout << "Samples = " << dec << ooo->get_samples() << endl;
+	cout << "Detailed CPI within the confidence interval = "
+	     << (ooo->get_sampled_CPI() - ooo->get_sampled_CPI_error() <= cpi
+		 && cpi <= ooo->get_sampled_CPI() + ooo->get_sampled_CPI_error() ? "yes" : "no") << endl;
+	cout << "Same registers and memory as the detailed run = " << (final_state(ooo) == final_state(reference) ? "yes" : "no") << endl;
+	delete ooo;
+
+	// an empty window gives no sample, and must not stall the run or divide by zero
+	unsigned long long windows[][3] = {{0, 0, 0}, {50, 10, 0}};
+	for (unsigned i = 0; i < 2; i++)
+	{
+		cout << "\nSAMPLED RUN: " << windows[i][0] << " FAST-FORWARDED, " << windows[i][1] << " WARMUP, "
+		     << windows[i][2] << " MEASURED..." << endl;
+		cout << "======================================================================" << endl << endl;
+
+		ooo = new_sort_sim();
+		ooo->run_sampled(windows[i][0], windows[i][1], windows[i][2]);
+		cout << "Samples = " << dec << ooo->get_samples() << endl;
+		cout << "Sampled CPI = " << ooo->get_sampled_CPI() << " +/- " << ooo->get_sampled_CPI_error() << endl;
+		cout << "Program finished = " << (ooo->finished() ? "yes" : "no") << endl;
+		cout << "Same registers and memory as the detailed run = " << (final_state(ooo) == final_state(reference) ? "yes" : "no") << endl;
+		delete ooo;
+	}
+
+	delete reference;
+}
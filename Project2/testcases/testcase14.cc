@@ -0,0 +1,46 @@
+#include "common.h"
+
+/* Test case for the functional front: with the front thread supplying the results, the sort program */
+/* must take the same cycles and end in the same state as without it */
+
+int main(int argc, char **argv){
+
+	sim_ooo *reference = new_sort_sim();
+	reference->run();
+	cout << "\nTIMING MODEL ALONE..." << endl;
+	cout << "======================================================================" << endl << endl;
+	cout << "Instruction executed = " << dec << reference->get_instructions_executed() << endl;
+	cout << "Clock cycles = " << dec << reference->get_clock_cycles() << endl;
+
+	cout << "\nFUNCTIONAL FRONT FROM THE START..." << endl;
+	cout << "======================================================================" << endl << endl;
+
+	sim_ooo *ooo = new_sort_sim();
+	ooo->start_functional_front();
+	ooo->run();
+	ooo->stop_functional_front();
+	cout << "Instruction executed = " << dec << ooo->get_instructions_executed() << endl;
+	cout << "Clock cycles = " << dec << ooo->get_clock_cycles() << endl;
+	cout << "Same instructions, cycles, registers and memory as the timing model alone = "
+	     << (ooo->get_instructions_executed() == reference->get_instructions_executed()
+		 && ooo->get_clock_cycles() == reference->get_clock_cycles()
+		 && final_state(ooo) == final_state(reference) ? "yes" : "no") << endl;
+	delete ooo;
+
+	// starting the front squashes the instructions in flight, so only the result is the same
+	cout << "\nFUNCTIONAL FRONT STARTED AFTER 300 CYCLES..." << endl;
+	cout << "======================================================================" << endl << endl;
+
+	ooo = new_sort_sim();
+	ooo->run(300);
+	ooo->start_functional_front();
+	ooo->run();
+	ooo->stop_functional_front();
+	cout << "Instruction executed = " << dec << ooo->get_instructions_executed() << endl;
+	cout << "Clock cycles = " << dec << ooo->get_clock_cycles() << endl;
+	cout << "Same registers and memory as the timing model alone = "
+	     << (final_state(ooo) == final_state(reference) ? "yes" : "no") << endl;
+	delete ooo;
+
+	delete reference;
+}
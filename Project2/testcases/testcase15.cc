@@ -0,0 +1,42 @@
+#include "common.h"
+#include <stdio.h>
+
+/* Test case for traces: replaying a trace of the sort program must take the same cycles and */
+/* instructions, and leave the same registers, as running the program in the detailed model */
+
+int main(int argc, char **argv){
+
+	const char *trace_file = "testcase15.trc";
+
+	sim_ooo *capture = new_sort_sim();
+	cout << "\nTrace captured = " << (capture->capture_trace(trace_file) ? "yes" : "no") << endl;
+	delete capture;
+
+	sim_ooo *reference = new_sort_sim();
+	reference->run();
+	cout << "\nDETAILED RUN..." << endl;
+	cout << "======================================================================" << endl << endl;
+	cout << final_state(reference, false);
+	cout << "Instruction executed = " << dec << reference->get_instructions_executed() << endl;
+	cout << "Clock cycles = " << dec << reference->get_clock_cycles() << endl;
+
+	cout << "\nTRACE REPLAY..." << endl;
+	cout << "======================================================================" << endl << endl;
+	sim_ooo *replay = new_sort_sim();
+	cout << "Trace replayed = " << (replay->replay_trace(trace_file) ? "yes" : "no") << endl;
+	cout << "Instruction executed = " << dec << replay->get_instructions_executed() << endl;
+	cout << "Clock cycles = " << dec << replay->get_clock_cycles() << endl;
+	cout << "Same cycles, instructions and registers as the detailed run = "
+	     << (replay->get_clock_cycles() == reference->get_clock_cycles()
+		 && replay->get_instructions_executed() == reference->get_instructions_executed()
+		 && final_state(replay, false) == final_state(reference, false) ? "yes" : "no") << endl;
+	delete replay;
+
+	// a file that is not a trace is rejected
+	sim_ooo *bogus = new_sort_sim();
+	cout << "\nAssembly file replayed = " << (bogus->replay_trace("asm/sort.asm") ? "yes" : "no") << endl;
+	delete bogus;
+
+	delete reference;
+	remove(trace_file);
+}
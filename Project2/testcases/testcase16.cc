@@ -0,0 +1,40 @@
+#include "common.h"
+
+/* Test case for parallel slices: the sort program split into slices of 50 instructions must give the */
+/* cycles and instructions of a full run when every slice is warmed up from its exact pipeline state */
+/* (warmup longer than the program), and also with snapshots taken in the middle of the program. */
+/* With a commit width above 1 the warmup may end past the start of a slice, which must not make */
+/* consecutive slices overlap */
+
+int main(int argc, char **argv){
+
+	unsigned commit_widths[] = {1, 2, 4};
+	unsigned long long warmups[] = {100000, 20};
+	for (unsigned c = 0; c < 3; c++)
+	{
+		sim_ooo *reference = new_sort_sim(commit_widths[c]);
+		reference->run();
+		cout << "\nCOMMIT WIDTH " << commit_widths[c] << ", FULL RUN..." << endl;
+		cout << "======================================================================" << endl << endl;
+		cout << "Instruction executed = " << dec << reference->get_instructions_executed() << endl;
+		cout << "Clock cycles = " << dec << reference->get_clock_cycles() << endl;
+
+		for (unsigned i = 0; i < 2; i++)
+		{
+			cout << "\nCOMMIT WIDTH " << commit_widths[c] << ", SLICES OF 50 INSTRUCTIONS, WARMUP OF " << warmups[i] << "..." << endl;
+			cout << "======================================================================" << endl << endl;
+
+			sim_ooo *ooo = new_sort_sim(commit_widths[c]);
+			ooo->run_parallel(50, warmups[i], 2);
+			cout << "Instruction executed = " << dec << ooo->get_instructions_executed() << endl;
+			cout << "Clock cycles = " << dec << ooo->get_clock_cycles() << endl;
+			cout << "Same instructions and cycles as the full run = "
+			     << (ooo->get_instructions_executed() == reference->get_instructions_executed()
+				 && ooo->get_clock_cycles() == reference->get_clock_cycles() ? "yes" : "no") << endl;
+			cout << "Same registers and memory as the full run = " << (final_state(ooo) == final_state(reference) ? "yes" : "no") << endl;
+			delete ooo;
+		}
+
+		delete reference;
+	}
+}
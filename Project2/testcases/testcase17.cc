@@ -0,0 +1,40 @@
+#include "common.h"
+
+/* Test case for loop extrapolation: a counting loop reaches a steady state and is extrapolated, and must */
+/* report it while ending with the cycles and registers of an exact run; the sort program never settles */
+/* and must report that nothing was extrapolated */
+
+int main(int argc, char **argv){
+
+	const char *programs[] = {"asm/sum.asm", "asm/sort.asm"};
+	for (unsigned p = 0; p < 2; p++)
+	{
+		sim_ooo *exact = new_sort_sim();
+		exact->load_program(programs[p], 0x00000000);
+		exact->set_int_register(0, 0);
+		exact->run();
+		cout << "\n" << programs[p] << ", EXACT RUN..." << endl;
+		cout << "======================================================================" << endl << endl;
+		cout << "Instruction executed = " << dec << exact->get_instructions_executed() << endl;
+		cout << "Clock cycles = " << dec << exact->get_clock_cycles() << endl;
+
+		sim_ooo *ooo = new_sort_sim();
+		ooo->load_program(programs[p], 0x00000000);
+		ooo->set_int_register(0, 0);
+		ooo->set_loop_extrapolation(true);
+		ooo->run();
+		cout << "\n" << programs[p] << ", LOOP EXTRAPOLATION..." << endl;
+		cout << "======================================================================" << endl << endl;
+		ooo->print_extrapolation_stats();
+		cout << "Instruction executed = " << dec << ooo->get_instructions_executed() << endl;
+		cout << "Clock cycles = " << dec << ooo->get_clock_cycles() << endl;
+		cout << "Extrapolated = " << (ooo->get_extrapolations() != 0 ? "yes" : "no") << endl;
+		cout << "Same instructions, cycles, registers and memory as the exact run = "
+		     << (ooo->get_instructions_executed() == exact->get_instructions_executed()
+			 && ooo->get_clock_cycles() == exact->get_clock_cycles()
+			 && final_state(ooo) == final_state(exact) ? "yes" : "no") << endl;
+
+		delete exact;
+		delete ooo;
+	}
+}
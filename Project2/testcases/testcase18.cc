@@ -0,0 +1,110 @@
+#include "sim_ooo.h"
+#include <iostream>
+#include <stdlib.h>
+#include <sstream>
+
+using namespace std;
+
+/* Test case for the multi-core mode: two producer/consumer pairs share the data memory. Each producer */
+/* stores a running sum and then raises a flag, its consumer spins on the flag and copies the sum. */
+/* Per-core results and the shared memory must not depend on the number of threads or on the run */
+
+/* instantiates 4 cores: cores 0 and 2 run the producer, cores 1 and 3 the consumer, each pair on its own block */
+sim_multicore *new_system(){
+	sim_multicore *system = new sim_multicore(4,	//cores
+						  64*1024,	//memory size
+						  8,		//rob size
+						  2, 2, 2, 2,	//int, add, mult, load reservation stations
+						  2);		//issue width
+	for (unsigned c = 0; c < system->get_num_cores(); c++)
+	{
+		sim_ooo *core = system->core(c);
+		core->init_exec_unit(INTEGER, 2, 1);
+		core->init_exec_unit(ADDER, 3, 1);
+		core->init_exec_unit(MULTIPLIER, 5, 1);
+		core->init_exec_unit(DIVIDER, 10, 1);
+		core->init_exec_unit(MEMORY, 3, 1);
+		core->load_program(c % 2 == 0 ? "asm/producer.asm" : "asm/consumer.asm", 0x00000000);
+		core->set_int_register(0, 0);
+		core->set_int_register(10, 0x1000 + 0x100 * (c / 2));
+	}
+	system->write_memory(0x1004, 0); // flags
+	system->write_memory(0x1104, 0);
+	return system;
+}
+
+/* runs the system and returns everything it printed plus the registers of each core */
+string run_system(unsigned quantum, unsigned threads, bool print){
+	sim_multicore *system = new_system();
+	system->run(quantum, threads);
+
+	stringstream result;
+	streambuf *cout_buffer = cout.rdbuf(result.rdbuf());
+	system->print_memory(0x1000, 0x100c);
+	system->print_memory(0x1100, 0x110c);
+	system->print_stats();
+	for (unsigned c = 0; c < system->get_num_cores(); c++)
+	{
+		cout << "Core " << c << " registers:";
+		for (unsigned i = 1; i <= 10; i++)
+		{
+			cout << " R" << i << "=" << system->core(c)->get_int_register(i);
+		}
+		cout << endl;
+	}
+	cout.rdbuf(cout_buffer);
+	delete system;
+
+	if (print)
+	{
+		cout << result.str();
+	}
+	return result.str();
+}
+
+int main(int argc, char **argv){
+
+	// store log of a single core: every committed store is recorded in order
+	cout << "\nSTORE LOG OF A SINGLE CORE..." << endl;
+	cout << "======================================================================" << endl << endl;
+
+	sim_ooo *single = new sim_ooo(64*1024, 8, 2, 2, 2, 2, 2);
+	single->init_exec_unit(INTEGER, 2, 1);
+	single->init_exec_unit(ADDER, 3, 1);
+	single->init_exec_unit(MULTIPLIER, 5, 1);
+	single->init_exec_unit(DIVIDER, 10, 1);
+	single->init_exec_unit(MEMORY, 3, 1);
+	single->load_program("asm/producer.asm", 0x00000000);
+	single->set_int_register(0, 0);
+	single->set_int_register(10, 0x1000);
+	single->set_store_log(true);
+	single->run();
+	unsigned address, value;
+	cout << "Stores logged = " << single->get_store_log_length() << endl;
+	single->get_logged_store(0, address, value);
+	cout << "First store: " << hex << "0x" << address << " = " << dec << value << endl;
+	single->get_logged_store(single->get_store_log_length() - 2, address, value);
+	cout << "Last sum store: " << hex << "0x" << address << " = " << dec << value << endl;
+	single->get_logged_store(single->get_store_log_length() - 1, address, value);
+	cout << "Flag store: " << hex << "0x" << address << " = " << dec << value << endl;
+	single->clear_store_log();
+	cout << "Stores logged after clear = " << single->get_store_log_length() << endl;
+	delete single;
+
+	// every quantum ends at a barrier, so the consumers see the flags and sums in the same cycle on every run
+	unsigned quanta[] = {1, 100};
+	for (unsigned q = 0; q < 2; q++)
+	{
+		cout << "\nFOUR CORES, QUANTUM OF " << quanta[q] << " CYCLES..." << endl;
+		cout << "======================================================================" << endl << endl;
+
+		string reference = run_system(quanta[q], 1, true);
+		bool identical = true;
+		for (unsigned repeat = 0; repeat < 3; repeat++)
+		{
+			identical = identical && run_system(quanta[q], 1, false) == reference;
+			identical = identical && run_system(quanta[q], 0, false) == reference;
+		}
+		cout << "Identical on 1 and 4 threads over repeated runs = " << (identical ? "yes" : "no") << endl;
+	}
+}
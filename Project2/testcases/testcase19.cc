@@ -0,0 +1,34 @@
+#include "common.h"
+
+/* Test case for branch prediction: the sort program runs with each predictor and the BTB; the branch */
+/* counters change with the predictor, but the registers and memory must match the not-taken run */
+
+int main(int argc, char **argv){
+
+	sim_ooo *reference = new_sort_sim();
+	reference->run();
+
+	predictor_t predictors[] = {PREDICT_NOT_TAKEN, PREDICT_BIMODAL, PREDICT_GSHARE, PREDICT_TAGE};
+	const char *names[] = {"NOT TAKEN", "BIMODAL", "GSHARE", "TAGE"};
+	unsigned btb_sizes[] = {64, 2};
+	for (unsigned p = 0; p < 4; p++)
+	{
+		for (unsigned b = 0; b < (predictors[p] == PREDICT_NOT_TAKEN ? 1 : 2); b++) // not-taken never uses the BTB
+		{
+			cout << "\n" << names[p] << " PREDICTOR, " << btb_sizes[b] << "-ENTRY BTB..." << endl;
+			cout << "======================================================================" << endl << endl;
+
+			sim_ooo *ooo = new_sort_sim();
+			ooo->set_branch_predictor(predictors[p], 10, btb_sizes[b]);
+			ooo->run();
+			ooo->print_branch_stats();
+			cout << "Instruction executed = " << dec << ooo->get_instructions_executed() << endl;
+			cout << "Clock cycles = " << dec << ooo->get_clock_cycles() << endl;
+			cout << "Same registers and memory as the not-taken run = "
+			     << (final_state(ooo) == final_state(reference) ? "yes" : "no") << endl;
+			delete ooo;
+		}
+	}
+
+	delete reference;
+}
@@ -0,0 +1,38 @@
+#include "common.h"
+
+/* Test case for early branch resolution: squashing only the instructions after a mispredicted branch */
+/* when it writes its result must end the sort program in the same state as flushing at commit, */
+/* in fewer cycles */
+
+int main(int argc, char **argv){
+
+	predictor_t predictors[] = {PREDICT_NOT_TAKEN, PREDICT_GSHARE};
+	const char *names[] = {"NOT TAKEN", "GSHARE"};
+	for (unsigned p = 0; p < 2; p++)
+	{
+		sim_ooo *at_commit = new_sort_sim();
+		at_commit->set_branch_predictor(predictors[p]);
+		at_commit->run();
+		cout << "\n" << names[p] << " PREDICTOR, RECOVERY AT COMMIT..." << endl;
+		cout << "======================================================================" << endl << endl;
+		cout << "Mispredictions = " << dec << at_commit->get_mispredictions() << endl;
+		cout << "Clock cycles = " << dec << at_commit->get_clock_cycles() << endl;
+
+		sim_ooo *early = new_sort_sim();
+		early->set_branch_predictor(predictors[p]);
+		early->set_early_resolution(true);
+		early->run();
+		cout << "\n" << names[p] << " PREDICTOR, EARLY RESOLUTION..." << endl;
+		cout << "======================================================================" << endl << endl;
+		cout << "Mispredictions = " << dec << early->get_mispredictions() << endl;
+		cout << "Clock cycles = " << dec << early->get_clock_cycles() << endl;
+		cout << "Same instructions, registers and memory as recovery at commit = "
+		     << (early->get_instructions_executed() == at_commit->get_instructions_executed()
+			 && final_state(early) == final_state(at_commit) ? "yes" : "no") << endl;
+		cout << "Fewer cycles than recovery at commit = "
+		     << (early->get_clock_cycles() < at_commit->get_clock_cycles() ? "yes" : "no") << endl;
+
+		delete at_commit;
+		delete early;
+	}
+}
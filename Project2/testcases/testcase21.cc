@@ -0,0 +1,31 @@
+#include "common.h"
+
+/* Test case for rename checkpoints: with fewer checkpoints than branches in flight, issue waits for one */
+/* to be freed; the wait must be counted and the sort program must end in the same state */
+
+int main(int argc, char **argv){
+
+	sim_ooo *reference = new_sort_sim();
+	reference->run();
+
+	unsigned counts[] = {0, 2, 1};
+	for (unsigned c = 0; c < 3; c++)
+	{
+		cout << "\nRENAME CHECKPOINTS = " << counts[c] << (counts[c] == 0 ? " (ONE PER ROB ENTRY)..." : "...") << endl;
+		cout << "======================================================================" << endl << endl;
+
+		sim_ooo *ooo = new_sort_sim();
+		ooo->set_rename_checkpoints(counts[c]);
+		ooo->run();
+		ooo->print_branch_stats();
+		cout << "Checkpoint stalls = " << dec << ooo->get_checkpoint_stalls() << endl;
+		cout << "Issue waited for a free checkpoint = " << (ooo->get_checkpoint_stalls() != 0 ? "yes" : "no") << endl;
+		cout << "Clock cycles = " << dec << ooo->get_clock_cycles() << endl;
+		cout << "Same instructions, registers and memory as the run without a limit = "
+		     << (ooo->get_instructions_executed() == reference->get_instructions_executed()
+			 && final_state(ooo) == final_state(reference) ? "yes" : "no") << endl;
+		delete ooo;
+	}
+
+	delete reference;
+}
@@ -0,0 +1,65 @@
+#include "common.h"
+
+/* Test case for the load/store queue: loads that follow stores to the same address in flight must take */
+/* the stored value, either forwarded from the store or once the store has written memory */
+
+/* instantiates a 2-issue processor with a 16-entry rob and one memory unit */
+sim_ooo *new_sim(){
+	sim_ooo *ooo = new sim_ooo(1024*1024,	//memory size
+				   16,          //rob size
+				   4, 4, 4, 4,  //int, add, mult, load reservation stations
+				   2,           //issue width
+				   2);          //commit width
+
+	ooo->init_exec_unit(INTEGER, 1, 2);
+	ooo->init_exec_unit(ADDER, 2, 1);
+	ooo->init_exec_unit(MULTIPLIER, 6, 1);
+	ooo->init_exec_unit(DIVIDER, 20, 1);
+	ooo->init_exec_unit(MEMORY, 3, 1);
+	return ooo;
+}
+
+int main(int argc, char **argv){
+
+	unsigned i, j;
+
+	// code_ooo5: overlapping stores and loads on 0xA008 and 0xA00C; F4, F5 and F6 must read 102, 2 and 204
+	cout << "\nSTORES AND LOADS ON THE SAME WORDS..." << endl;
+	cout << "======================================================================" << endl << endl;
+
+	sim_ooo *ooo = new_sim();
+	ooo->load_program("asm/code_ooo5.asm", 0x00000000);
+	ooo->set_int_register(1, 0xA000);
+	ooo->set_int_register(2, 0xA004);
+	ooo->set_fp_register(1, 100.0);
+	for (i = 0xA000, j=1; i<0xA020; i+=4, j+=1) ooo->write_memory(i,float2unsigned((float)(j)));
+	ooo->run();
+
+	ooo->print_registers();
+	ooo->print_memory(0xA000, 0xA020);
+	ooo->print_lsq_stats();
+	cout << "Loads read the stored values = "
+	     << (ooo->get_fp_register(4) == 102.0 && ooo->get_fp_register(5) == 2.0 && ooo->get_fp_register(6) == 204.0 ? "yes" : "no") << endl;
+	cout << "Clock cycles = " << dec << ooo->get_clock_cycles() << endl;
+	delete ooo;
+
+	// store_load: each iteration stores R5 and loads it back right away, and R7 adds up 20 + 19 + ... + 1.
+	// The loop branch is predicted so that the next iterations are in flight while a store waits to commit
+	cout << "\nLOAD RIGHT AFTER A STORE IN A LOOP..." << endl;
+	cout << "======================================================================" << endl << endl;
+
+	ooo = new_sim();
+	ooo->set_branch_predictor(PREDICT_TAGE);
+	ooo->load_program("asm/store_load.asm", 0x00000000);
+	ooo->set_int_register(0, 0);
+	ooo->set_int_register(7, 0);
+	ooo->run();
+
+	ooo->print_memory(0xA000, 0xA050);
+	ooo->print_lsq_stats();
+	cout << "Forwarded loads = " << dec << ooo->get_forwarded_loads() << endl;
+	cout << "Memory conflicts = " << dec << ooo->get_memory_conflicts() << endl;
+	cout << "R7 = " << dec << ooo->get_int_register(7) << " (expected 210)" << endl;
+	cout << "Clock cycles = " << dec << ooo->get_clock_cycles() << endl;
+	delete ooo;
+}